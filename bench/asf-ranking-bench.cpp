@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+/* Per-Interest cost of ranking the next hops in MAsfStrategy, with the
+ * std::set it used to build for every Interest and with the stack buffer
+ * of asf-face-ranking.hpp: picking the face to forward to (best face) and
+ * the face to probe (random rank). The strategy needs NFD, so the ranking
+ * is run alone, on faces with random measurements. */
+
+#include "asf-face-ranking.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+#include <unistd.h>
+
+namespace nfd {
+namespace fw {
+namespace asf {
+
+struct BenchFace
+{
+  uint64_t
+  getId() const
+  {
+    return id;
+  }
+
+  uint64_t id;
+};
+
+using Stats = BasicFaceStats<BenchFace>;
+using Compare = BasicFaceStatsCompare<BenchFace>;
+
+/* 1 in 8 next hops never measured, 1 in 8 timed out */
+static std::vector<Stats>
+makeNextHops(std::vector<BenchFace>& faces, std::mt19937& rng)
+{
+  std::uniform_int_distribution<int64_t> rttDist(1000000, 200000000);
+  std::vector<Stats> hops;
+  for (auto& face : faces) {
+    ndn::time::nanoseconds rtt(rttDist(rng));
+    ndn::time::nanoseconds srtt(rttDist(rng));
+    switch (rng() % 8) {
+      case 0:
+        rtt = srtt = ndn::time::nanoseconds(-1);
+        break;
+      case 1:
+        rtt = ndn::time::nanoseconds(-2);
+        break;
+    }
+    hops.push_back({&face, rtt, srtt, face.id % 4 + 1, 0});
+  }
+  return hops;
+}
+
+template<typename F>
+static double
+measureNsPerCall(double seconds, F&& f)
+{
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  auto deadline = start + std::chrono::duration<double>(seconds);
+  uint64_t n = 0;
+  while (clock::now() < deadline) {
+    for (int i = 0; i < 256; ++i)
+      f();
+    n += 256;
+  }
+  return std::chrono::duration<double, std::nano>(clock::now() - start).count() / n;
+}
+
+/* keeps the compiler from dropping the ranking */
+static volatile uint64_t g_sink;
+
+static void
+bench(size_t nHops, double seconds)
+{
+  std::mt19937 rng(nHops);
+  std::uniform_real_distribution<> randDist;
+  std::vector<BenchFace> faces;
+  for (size_t i = 0; i < nHops; ++i)
+    faces.push_back({256 + i});
+  std::vector<Stats> hops = makeNextHops(faces, rng);
+
+  double setBest = measureNsPerCall(seconds, [&] {
+    std::set<Stats, Compare> ranked;
+    for (const auto& hop : hops)
+      ranked.insert(hop);
+    g_sink = ranked.begin()->face->getId();
+  });
+
+  double scanBest = measureNsPerCall(seconds, [&] {
+    Compare isBetter;
+    Stats best{nullptr, ndn::time::nanoseconds(-1), ndn::time::nanoseconds(-1), 0, 0};
+    for (const auto& hop : hops) {
+      if (best.face == nullptr || isBetter(hop, best))
+        best = hop;
+    }
+    g_sink = best.face->getId();
+  });
+
+  double setProbe = measureNsPerCall(seconds, [&] {
+    std::set<Stats, Compare> ranked;
+    for (const auto& hop : hops)
+      ranked.insert(hop);
+    auto it = ranked.begin();
+    std::advance(it, drawProbingRank(ranked.size(), randDist(rng)));
+    g_sink = it->face->getId();
+  });
+
+  double bufferProbe = measureNsPerCall(seconds, [&] {
+    BasicRankedFaces<BenchFace> ranked;
+    for (const auto& hop : hops)
+      ranked.push_back(hop);
+    size_t rank = drawProbingRank(ranked.size(), randDist(rng));
+    g_sink = selectRankedFace(ranked, rank)->getId();
+  });
+
+  std::cout << "next_hops=" << nHops
+            << " best_set_ns=" << static_cast<uint64_t>(setBest)
+            << " best_scan_ns=" << static_cast<uint64_t>(scanBest)
+            << " probe_set_ns=" << static_cast<uint64_t>(setProbe)
+            << " probe_buffer_ns=" << static_cast<uint64_t>(bufferProbe) << std::endl;
+}
+
+} // namespace asf
+} // namespace fw
+} // namespace nfd
+
+int main(int32_t argc, char** argv)
+{
+  double seconds = 1;
+
+  int32_t opt;
+  while ((opt = getopt(argc, argv, "D:h")) != -1) {
+    switch (opt) {
+      case 'D':
+        seconds = strtod(optarg, NULL);
+        break;
+      case 'h':
+      default:
+        std::cout << "Usage: " << argv[0] << " [-D <seconds per measure (default: 1)>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+  }
+
+  for (size_t nHops : {2, 8, 32})
+    nfd::fw::asf::bench(nHops, seconds);
+
+  return EXIT_SUCCESS;
+}
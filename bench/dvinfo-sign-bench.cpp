@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+/* Signatures (and verifications) per second of each DvInfo signing
+ * scheme, on a DvInfo of realistic size. */
+
+#include "dvinfo-signer.hpp"
+#include "ndvr-message.pb.h"
+#include "ndvr-security-helper.hpp"
+
+#include <ndn-cxx/security/verification-helpers.hpp>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <unistd.h>
+
+namespace ndn {
+namespace ndvr {
+
+static std::shared_ptr<Data>
+makeDvInfo(const Name& routerPrefix, size_t nEntries)
+{
+  proto::DvInfo dvinfo_proto;
+  for (size_t i = 0; i < nEntries; ++i) {
+    auto* entry = dvinfo_proto.add_entry();
+    entry->set_prefix("/ndn/site" + std::to_string(i));
+    entry->set_seq(i + 2);
+    entry->set_originator("/ndn/%C1.Router/router" + std::to_string(i));
+    entry->set_cost(i % 8 + 1);
+    auto* next_hop = new proto::DvInfo_NextHop();
+    next_hop->add_router_id(routerPrefix.toUri());
+    entry->set_allocated_next_hops(next_hop);
+  }
+  std::string dvinfo_str;
+  dvinfo_proto.AppendToString(&dvinfo_str);
+
+  Name name("/localhop/ndvr/dvinfo");
+  name.append(routerPrefix).appendNumber(1);
+  auto data = std::make_shared<Data>(name);
+  data->setFreshnessPeriod(time::milliseconds(1000));
+  data->setContent(make_span(reinterpret_cast<const uint8_t*>(dvinfo_str.c_str()), dvinfo_str.size()));
+  return data;
+}
+
+template<typename F>
+static double
+measureRate(double seconds, F&& f)
+{
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  auto deadline = start + std::chrono::duration<double>(seconds);
+  uint64_t n = 0;
+  while (clock::now() < deadline) {
+    /* check the clock every few iterations only, HMAC is very fast */
+    for (int i = 0; i < 16; ++i)
+      f();
+    n += 16;
+  }
+  return n / std::chrono::duration<double>(clock::now() - start).count();
+}
+
+static void
+bench(DvInfoSigner& signer, const Data& dvinfo, double seconds,
+      const std::function<bool(const Data&)>& verify)
+{
+  Data data(dvinfo);
+  double signRate = measureRate(seconds, [&] { signer.sign(data); });
+
+  signer.sign(data);
+  if (!verify(data)) {
+    std::cout << "scheme=" << signer.getName() << " ERROR: signature does not verify" << std::endl;
+    return;
+  }
+  double verifyRate = measureRate(seconds, [&] { verify(data); });
+
+  std::cout << "scheme=" << signer.getName()
+            << " data_size=" << data.wireEncode().size()
+            << " sign_per_sec=" << static_cast<uint64_t>(signRate)
+            << " verify_per_sec=" << static_cast<uint64_t>(verifyRate) << std::endl;
+}
+
+} // namespace ndvr
+} // namespace ndn
+
+int main(int32_t argc, char** argv)
+{
+  using namespace ndn;
+  using namespace ndn::ndvr;
+
+  size_t nEntries = 100;
+  double seconds = 2;
+
+  int32_t opt;
+  while ((opt = getopt(argc, argv, "e:D:h")) != -1) {
+    switch (opt) {
+      case 'e':
+        nEntries = strtoul(optarg, NULL, 10);
+        break;
+      case 'D':
+        seconds = strtod(optarg, NULL);
+        break;
+      case 'h':
+      default:
+        std::cout << "Usage: " << argv[0] << " [-e <DvInfo entries (default: 100)>] [-D <seconds per scheme (default: 2)>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+  }
+
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+  Name network("/ndn");
+  Name routerPrefix("/ndn/%C1.Router/bench");
+  keyChain.createIdentity(network);
+  security::SigningInfo signingInfo = setupSigningInfo(keyChain, routerPrefix, network);
+  auto dvinfo = makeDvInfo(routerPrefix, nEntries);
+
+  KeyChainDvInfoSigner ecdsa(keyChain, signingInfo);
+  security::pib::Key key = keyChain.getPib().getIdentity(routerPrefix).getDefaultKey();
+  bench(ecdsa, *dvinfo, seconds, [&key] (const Data& data) {
+    return security::verifySignature(data, key.getPublicKey().data(), key.getPublicKey().size());
+  });
+
+  HmacDvInfoSigner hmac(network, "bench network secret");
+  bench(hmac, *dvinfo, seconds, [&hmac] (const Data& data) {
+    return hmac.verify(data);
+  });
+
+  return EXIT_SUCCESS;
+}
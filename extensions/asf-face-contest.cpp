@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "asf-face-contest.hpp"
+#include "common/logger.hpp"
+
+namespace nfd {
+namespace fw {
+namespace asf {
+
+NFD_LOG_INIT(AsfFaceContest);
+
+constexpr time::milliseconds FaceContest::DEFAULT_THRESHOLD;
+constexpr double FaceContest::DEFAULT_MARGIN;
+
+FaceContest::FaceContest()
+  : m_threshold(DEFAULT_THRESHOLD)
+  , m_margin(DEFAULT_MARGIN)
+{
+}
+
+void
+FaceContest::setThreshold(time::milliseconds threshold)
+{
+  if (threshold < 0_ms) {
+    NDN_THROW(std::invalid_argument("Face contest threshold must be non-negative"));
+  }
+  m_threshold = threshold;
+}
+
+void
+FaceContest::setMargin(double margin)
+{
+  if (margin < 0 || margin >= 1) {
+    NDN_THROW(std::invalid_argument("Face contest margin must be in [0, 1)"));
+  }
+  m_margin = margin;
+}
+
+bool
+FaceContest::beatsPrimary(const FaceInfo& topInfo, const FaceInfo* primaryInfo) const
+{
+  if (primaryInfo == nullptr || primaryInfo->getLastRtt() < 0_ns ||
+      primaryInfo->getSrtt() < 0_ns) {
+    return true;
+  }
+  if (topInfo.getSrtt() < 0_ns) {
+    return false;
+  }
+  return topInfo.getSrtt().count() < primaryInfo->getSrtt().count() * (1 - m_margin);
+}
+
+void
+FaceContest::update(NamespaceInfo& nsInfo, Face& topFace, const FaceInfo& topInfo)
+{
+  NamespaceInfo::BestPrefixFace& contest = *nsInfo.getFaceContest();
+  if (contest.primaryFace == nullptr) {
+    NFD_LOG_DEBUG("Primary face is nullptr. Set it to current top face " << topFace.getId());
+    contest.primaryFace = &topFace;
+    return;
+  }
+
+  if (&topFace == contest.primaryFace) {
+    contest.contest = false;
+    return;
+  }
+
+  if (!beatsPrimary(topInfo, nsInfo.getFaceInfo(contest.primaryFace->getId()))) {
+    NFD_LOG_TRACE("Top face " << topFace.getId() << " is within the margin of primary face "
+                  << contest.primaryFace->getId() << ", no contest");
+    contest.contest = false;
+    return;
+  }
+
+  auto now = time::steady_clock::now();
+  if (!contest.contest || contest.bestFace != &topFace) {
+    NFD_LOG_DEBUG("Top face " << topFace.getId() << " contests primary face "
+                  << contest.primaryFace->getId());
+    contest.bestFace = &topFace;
+    contest.contest = true;
+    contest.changeTime = now;
+    ++contest.nContests;
+    return;
+  }
+
+  if (now - contest.changeTime >= m_threshold) {
+    NFD_LOG_DEBUG("Changing the primary face from " << contest.primaryFace->getId()
+                  << " to " << topFace.getId() << " (contests=" << contest.nContests
+                  << " switches=" << contest.nSwitches + 1 << ")");
+    contest.primaryFace = &topFace;
+    contest.contest = false;
+    contest.changeTime = now;
+    ++contest.nSwitches;
+  }
+}
+
+} // namespace asf
+} // namespace fw
+} // namespace nfd
@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NFD_DAEMON_FW_ASF_FACE_CONTEST_HPP
+#define NFD_DAEMON_FW_ASF_FACE_CONTEST_HPP
+
+#include "asf-measurements.hpp"
+
+namespace nfd {
+namespace fw {
+namespace asf {
+
+/** \brief Hysteresis on the primary face of each namespace
+ *
+ *  When another face ranks above the primary face, a contest starts; the
+ *  contending face becomes primary if it stays on top for the threshold time.
+ *  During a contest MAsfStrategy sends to both faces, so contests between
+ *  faces of about the same SRTT are avoided: the contender must beat the
+ *  primary face's SRTT by the relative margin (unless the primary face has
+ *  no valid measurement). Elapsed time is taken from the steady clock,
+ *  which ndnSIM drives from simulation time.
+ */
+class FaceContest
+{
+public:
+  FaceContest();
+
+  /** \brief Updates the contest of \p nsInfo after \p topFace ranked first
+   *  \param topInfo measurements of \p topFace
+   */
+  void
+  update(NamespaceInfo& nsInfo, Face& topFace, const FaceInfo& topInfo);
+
+  void
+  setThreshold(time::milliseconds threshold);
+
+  time::milliseconds
+  getThreshold() const
+  {
+    return m_threshold;
+  }
+
+  /** \param margin fraction of the primary face's SRTT, in [0, 1)
+   */
+  void
+  setMargin(double margin);
+
+  double
+  getMargin() const
+  {
+    return m_margin;
+  }
+
+private:
+  bool
+  beatsPrimary(const FaceInfo& topInfo, const FaceInfo* primaryInfo) const;
+
+public:
+  static constexpr time::milliseconds DEFAULT_THRESHOLD = 2_s;
+  static constexpr double DEFAULT_MARGIN = 0.1;
+
+private:
+  time::milliseconds m_threshold;
+  double m_margin;
+};
+
+} // namespace asf
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_ASF_FACE_CONTEST_HPP
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NFD_DAEMON_FW_ASF_FACE_RANKING_HPP
+#define NFD_DAEMON_FW_ASF_FACE_RANKING_HPP
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <boost/container/small_vector.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace nfd {
+namespace fw {
+namespace asf {
+
+/** \brief RTT measurements of one next hop, to rank it against the others
+ *
+ *  Templated on the face type only so that the ranking can be exercised
+ *  without a forwarder (bench/asf-ranking-bench); MAsfStrategy uses
+ *  FaceStats (asf-measurements.hpp).
+ */
+template<typename FaceT>
+struct BasicFaceStats
+{
+  FaceT* face;
+  ndn::time::nanoseconds rtt;
+  ndn::time::nanoseconds srtt;
+  uint64_t cost;
+  // Interests forwarded and not answered yet, for load splitting
+  size_t nInFlight;
+};
+
+/** \brief Faces with a last RTT first, then those never measured, then the timed
+ *         out ones (FaceInfo::RTT_NO_MEASUREMENT is -1 and RTT_TIMEOUT -2);
+ *         ties are broken by SRTT, cost and FaceId
+ */
+template<typename FaceT>
+struct BasicFaceStatsCompare
+{
+  bool
+  operator()(const BasicFaceStats<FaceT>& lhs, const BasicFaceStats<FaceT>& rhs) const
+  {
+    return key(lhs) < key(rhs);
+  }
+
+private:
+  static std::tuple<int64_t, int64_t, uint64_t, uint64_t>
+  key(const BasicFaceStats<FaceT>& stats)
+  {
+    int64_t rtt = stats.rtt.count() >= 0 ? 0 : -stats.rtt.count();
+    int64_t srtt = stats.srtt.count() == -1 ? std::numeric_limits<int64_t>::max()
+                                            : stats.srtt.count();
+    return std::make_tuple(rtt, srtt, stats.cost, static_cast<uint64_t>(stats.face->getId()));
+  }
+};
+
+/** \brief Next hops being ranked for one Interest
+ *
+ *  Kept on the stack up to 32 next hops, more than FIB entries have in
+ *  practice, so that ranking does not allocate per packet.
+ */
+template<typename FaceT>
+using BasicRankedFaces = boost::container::small_vector<BasicFaceStats<FaceT>, 32>;
+
+/** \return the face ranked \p rank (0 is the best) in \p faces, which is only
+ *          partially sorted (nth_element), enough to find it
+ */
+template<typename FaceT>
+FaceT*
+selectRankedFace(BasicRankedFaces<FaceT>& faces, size_t rank)
+{
+  std::nth_element(faces.begin(), faces.begin() + rank, faces.end(),
+                   BasicFaceStatsCompare<FaceT>());
+  return faces[rank].face;
+}
+
+/** \brief Draws the rank (0 is the best) of the face to probe among \p nFaces
+ *
+ *  Rank r has probability (nFaces - r) / (1 + 2 + ... + nFaces), so better
+ *  faces are probed more often. \p randomNumber is uniform in [0, 1).
+ */
+inline size_t
+drawProbingRank(size_t nFaces, double randomNumber)
+{
+  double rankSum = static_cast<double>((nFaces + 1) * nFaces) / 2;
+  double offset = 0.0;
+  for (size_t rank = 0; rank + 1 < nFaces; ++rank) {
+    offset += (nFaces - rank) / rankSum;
+    if (randomNumber <= offset) {
+      return rank;
+    }
+  }
+  return nFaces - 1;
+}
+
+/** \brief Picks one of the \p k best ranked \p faces, in proportion to
+ *         1 / (SRTT * (1 + Interests in flight))
+ *
+ *  The faces must all have an SRTT. \p randomNumber is uniform in [0, 1).
+ */
+template<typename FaceT>
+FaceT*
+selectWeightedFace(BasicRankedFaces<FaceT>& faces, size_t k, double randomNumber)
+{
+  k = std::min(k, faces.size());
+  if (k < faces.size()) {
+    std::nth_element(faces.begin(), faces.begin() + k, faces.end(),
+                     BasicFaceStatsCompare<FaceT>());
+  }
+
+  auto weight = [] (const BasicFaceStats<FaceT>& stats) {
+    double srtt = std::max<double>(stats.srtt.count(), 1);
+    return 1.0 / (srtt * (1 + stats.nInFlight));
+  };
+  double weightSum = 0.0;
+  for (size_t i = 0; i < k; ++i) {
+    weightSum += weight(faces[i]);
+  }
+
+  double offset = 0.0;
+  for (size_t i = 0; i + 1 < k; ++i) {
+    offset += weight(faces[i]) / weightSum;
+    if (randomNumber < offset) {
+      return faces[i].face;
+    }
+  }
+  return faces[k - 1].face;
+}
+
+} // namespace asf
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_ASF_FACE_RANKING_HPP
@@ -60,7 +60,11 @@ FaceInfo*
 NamespaceInfo::getFaceInfo(FaceId faceId)
 {
   auto it = m_fiMap.find(faceId);
-  return it != m_fiMap.end() ? &it->second : nullptr;
+  if (it == m_fiMap.end() || it->second.m_expirationTime <= time::steady_clock::now()) {
+    // an expired entry is left to the sweep: callers may hold other FaceInfo pointers
+    return nullptr;
+  }
+  return &it->second;
 }
 
 FaceInfo&
@@ -73,14 +77,41 @@ NamespaceInfo::getOrCreateFaceInfo(FaceId faceId)
   if (ret.second) {
     extendFaceInfoLifetime(faceInfo, faceId);
   }
+  else if (faceInfo.m_expirationTime <= time::steady_clock::now()) {
+    // start over in place, as if the sweep had erased it
+    faceInfo = FaceInfo(m_rttEstimatorOpts);
+    extendFaceInfoLifetime(faceInfo, faceId);
+  }
+  if (!m_sweepEvent) {
+    m_sweepEvent = getScheduler().schedule(AsfMeasurements::MEASUREMENTS_LIFETIME,
+                                           [this] { sweepExpiredFaceInfo(); });
+  }
   return faceInfo;
 }
 
 void
-NamespaceInfo::extendFaceInfoLifetime(FaceInfo& info, FaceId faceId)
+NamespaceInfo::extendFaceInfoLifetime(FaceInfo& info, FaceId)
+{
+  info.m_expirationTime = time::steady_clock::now() + AsfMeasurements::MEASUREMENTS_LIFETIME;
+}
+
+void
+NamespaceInfo::sweepExpiredFaceInfo()
 {
-  info.m_measurementExpiration = getScheduler().schedule(AsfMeasurements::MEASUREMENTS_LIFETIME,
-                                                         [=] { m_fiMap.erase(faceId); });
+  auto now = time::steady_clock::now();
+  for (auto it = m_fiMap.begin(); it != m_fiMap.end();) {
+    if (it->second.m_expirationTime <= now) {
+      it = m_fiMap.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  if (!m_fiMap.empty()) {
+    m_sweepEvent = getScheduler().schedule(AsfMeasurements::MEASUREMENTS_LIFETIME,
+                                           [this] { sweepExpiredFaceInfo(); });
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
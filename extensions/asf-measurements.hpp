@@ -26,6 +26,7 @@
 #ifndef NFD_DAEMON_FW_ASF_MEASUREMENTS_HPP
 #define NFD_DAEMON_FW_ASF_MEASUREMENTS_HPP
 
+#include "asf-face-ranking.hpp"
 #include "fw/strategy-info.hpp"
 #include "table/measurements-accessor.hpp"
 
@@ -132,6 +133,38 @@ public:
     return m_lastTimeForwarded;
   }
 
+  /** \brief Interests forwarded on the face and not answered yet
+   *
+   *  Only one RTO timer runs per face, so Interests lost without a Nack are
+   *  not counted out one by one: when the RTO fires, all those in flight are
+   *  presumed lost (clearInFlight).
+   */
+  size_t
+  getNInFlight() const
+  {
+    return m_nInFlight;
+  }
+
+  void
+  addInFlight()
+  {
+    ++m_nInFlight;
+  }
+
+  void
+  removeInFlight()
+  {
+    if (m_nInFlight > 0) {
+      --m_nInFlight;
+    }
+  }
+
+  void
+  clearInFlight()
+  {
+    m_nInFlight = 0;
+  }
+
 public:
   static const time::nanoseconds RTT_NO_MEASUREMENT;
   static const time::nanoseconds RTT_TIMEOUT;
@@ -144,9 +177,10 @@ private:
   size_t m_nSilentTimeouts = 0;
   //bool m_isNacked = false;
   time::steady_clock::TimePoint m_lastTimeForwarded;
+  size_t m_nInFlight = 0;
 
-  // Timeout associated with measurement
-  scheduler::ScopedEventId m_measurementExpiration;
+  // Measurement is dropped once unused past this time (see NamespaceInfo)
+  time::steady_clock::TimePoint m_expirationTime;
   friend class NamespaceInfo;
 
   // RTO associated with Interest
@@ -157,6 +191,11 @@ private:
 ////////////////////////////////////////////////////////////////////////////////
 
 /** \brief Stores strategy information about each face in this namespace
+ *
+ *  A FaceInfo expires AsfMeasurements::MEASUREMENTS_LIFETIME after it was
+ *  last used. Extending the lifetime only moves a timestamp: expired entries
+ *  are ignored on access, and erased by a sweep every MEASUREMENTS_LIFETIME,
+ *  rather than rescheduling an event each time a face is used.
  */
 class NamespaceInfo : public StrategyInfo
 {
@@ -173,9 +212,13 @@ public:
   {
   }
 
+  /** \return the FaceInfo of \p faceId, nullptr if there is none or it expired
+   */
   FaceInfo*
   getFaceInfo(FaceId faceId);
 
+  /** \brief Gets the FaceInfo of \p faceId, new if there was none or it expired
+   */
   FaceInfo&
   getOrCreateFaceInfo(FaceId faceId);
 
@@ -206,12 +249,16 @@ public:
     m_isFirstProbeScheduled = isScheduled;
   }
 
+  /** \brief Primary face of the namespace and its contest (see FaceContest)
+   */
   struct BestPrefixFace
   {
     Face * primaryFace = nullptr;
     Face * bestFace = nullptr;
-		ndn::time::system_clock::TimePoint changeTime;
+    time::steady_clock::TimePoint changeTime;
     bool contest = false;
+    uint64_t nContests = 0;
+    uint64_t nSwitches = 0;
   };
 
   BestPrefixFace*
@@ -227,12 +274,17 @@ public:
     m_bestFace = fc;
   }
 
+private:
+  void
+  sweepExpiredFaceInfo();
+
 private:
   std::unordered_map<FaceId, FaceInfo> m_fiMap;
   shared_ptr<const ndn::util::RttEstimator::Options> m_rttEstimatorOpts;
   bool m_isProbingDue = false;
   bool m_isFirstProbeScheduled = false;
   BestPrefixFace* m_bestFace = nullptr;
+  scheduler::ScopedEventId m_sweepEvent;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -270,33 +322,9 @@ private:
   shared_ptr<const ndn::util::RttEstimator::Options> m_rttEstimatorOpts;
 };
 
-struct FaceStats
-{
-  Face* face;
-  time::nanoseconds rtt;
-  time::nanoseconds srtt;
-  uint64_t cost;
-};
-
-struct FaceStatsCompare
-{
-  bool
-  operator()(const FaceStats& lhs, const FaceStats& rhs) const
-  {
-    time::nanoseconds zeroValue = time::nanoseconds{0};
-    time::nanoseconds lhsRtt = lhs.rtt >= zeroValue ? zeroValue : -lhs.rtt;
-    time::nanoseconds rhsRtt = rhs.rtt >= zeroValue ? zeroValue : -rhs.rtt; 
-
-		time::nanoseconds lhsSrtt = lhs.srtt == FaceInfo::RTT_NO_MEASUREMENT ? time::nanoseconds::max() : lhs.srtt;
-    time::nanoseconds rhsSrtt = rhs.srtt == FaceInfo::RTT_NO_MEASUREMENT ? time::nanoseconds::max() : rhs.srtt;
-
-		FaceId lhsFaceId = lhs.face->getId();
-		FaceId rhsFaceId = rhs.face->getId();
-
-		return std::tie(lhsRtt, lhsSrtt, lhs.cost, lhsFaceId) < std::tie(rhsRtt, rhsSrtt, rhs.cost, rhsFaceId);
-  }
-};
-
+using FaceStats = BasicFaceStats<Face>;
+using FaceStatsCompare = BasicFaceStatsCompare<Face>;
+using RankedFaces = BasicRankedFaces<Face>;
 
 } // namespace asf
 } // namespace fw
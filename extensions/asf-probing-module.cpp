@@ -72,8 +72,9 @@ std::vector<Face*>
 ProbingModule::getUnprobedFaces(const Face& inFace,
         const Interest& interest,
         const fib::Entry& fibEntry,
-        const NamespaceInfo::BestPrefixFace& faceContest)
+        NamespaceInfo& info)
 {
+  const NamespaceInfo::BestPrefixFace& faceContest = *info.getFaceContest();
   std::vector<Face*> faces;
   for (const fib::NextHop& hop : fibEntry.getNextHops()) {
     Face& hopFace = hop.getFace();
@@ -85,9 +86,9 @@ ProbingModule::getUnprobedFaces(const Face& inFace,
       continue;
     }
 
-    FaceInfo* info = m_measurements.getFaceInfo(fibEntry, interest, hopFace.getId());
+    FaceInfo* faceInfo = info.getFaceInfo(hopFace.getId());
     // If no RTT has been recorded, probe this face
-    if (info == nullptr || info->getLastRtt() == FaceInfo::RTT_NO_MEASUREMENT) {
+    if (faceInfo == nullptr || faceInfo->getLastRtt() == FaceInfo::RTT_NO_MEASUREMENT) {
       faces.push_back(&hopFace);
     }
   }
@@ -97,11 +98,12 @@ ProbingModule::getUnprobedFaces(const Face& inFace,
 std::vector<Face*>
 ProbingModule::getFacesToProbe(const Face& inFace, const Interest& interest,
                               const fib::Entry& fibEntry,
-                              const NamespaceInfo::BestPrefixFace& faceContest,
+                              NamespaceInfo& info,
                               bool getTimedOutOrNackedFace)
 {
-  std::set<FaceStats, FaceStatsCompare> rankedFaces;
-  
+  const NamespaceInfo::BestPrefixFace& faceContest = *info.getFaceContest();
+  RankedFaces rankedFaces;
+
 	std::vector<Face*> faces;
   // Put eligible faces into rankedFaces. If a face does not have an RTT measurement,
   // immediately pick the face for probing
@@ -117,26 +119,20 @@ ProbingModule::getFacesToProbe(const Face& inFace, const Interest& interest,
       continue;
     }
 
-    FaceInfo* info = m_measurements.getFaceInfo(fibEntry, interest, hopFace.getId());
+    FaceInfo* faceInfo = info.getFaceInfo(hopFace.getId());
     // If no RTT has been recorded, always probe this face
-    if (info == nullptr || (info->getLastRtt() == FaceInfo::RTT_NO_MEASUREMENT)) {
+    if (faceInfo == nullptr || (faceInfo->getLastRtt() == FaceInfo::RTT_NO_MEASUREMENT)) {
       //NFD_LOG_DEBUG("Probing a face whose last rtt has no measurement.");
       faces.push_back(&hopFace);
     }
-    // Add FaceInfo to container sorted by RTT
+    // Rank the others by RTT (see chooseFace)
     else {
-			rankedFaces.insert({&hopFace, info->getLastRtt(), info->getSrtt(), hop.getCost()});
+      rankedFaces.push_back({&hopFace, faceInfo->getLastRtt(), faceInfo->getSrtt(), hop.getCost(),
+                             faceInfo->getNInFlight()});
     }
   }
 
   if (!rankedFaces.empty()) {
-		NFD_LOG_DEBUG("Current ranking of the faces for probing: ");
-		auto it1 = rankedFaces.begin();
-		for(; it1 != rankedFaces.end(); it1++) {
-			NFD_LOG_DEBUG("  Faceid: " << it1->face->getId() << ", " << it1->rtt << ", " << it1->srtt);
-		}
-
-		// No Face to probe
     faces.push_back(chooseFace(rankedFaces));
   }
   
@@ -144,11 +140,9 @@ ProbingModule::getFacesToProbe(const Face& inFace, const Interest& interest,
 }
 
 bool
-ProbingModule::isProbingNeeded(const fib::Entry& fibEntry, const Interest& interest)
+ProbingModule::isProbingNeeded(const fib::Entry& fibEntry, NamespaceInfo& info)
 {
   // Return the probing status flag for a namespace
-  NamespaceInfo& info = m_measurements.getOrCreateNamespaceInfo(fibEntry, interest);
-
   // If a first probe has not been scheduled for a namespace
   if (!info.isFirstProbeScheduled()) {
     // Schedule first probe between 0 and 5 seconds
@@ -162,56 +156,33 @@ ProbingModule::isProbingNeeded(const fib::Entry& fibEntry, const Interest& inter
 }
 
 void
-ProbingModule::afterForwardingProbe(const fib::Entry& fibEntry, const Interest& interest)
+ProbingModule::afterForwardingProbe(const fib::Entry& fibEntry, NamespaceInfo& info)
 {
   // After probing is done, need to set probing flag to false and
   // schedule another future probe
-  NamespaceInfo& info = m_measurements.getOrCreateNamespaceInfo(fibEntry, interest);
   info.setIsProbingDue(false);
 
   scheduleProbe(fibEntry, m_probingInterval);
 }
 
 Face*
-ProbingModule::chooseFace(const std::set<FaceStats, FaceStatsCompare>& rankedFaces)
+ProbingModule::chooseFace(RankedFaces& rankedFaces)
 {
   static std::uniform_real_distribution<> randDist;
   double randomNumber = randDist(ndn::random::getRandomNumberEngine());
-  uint64_t rankSum = (rankedFaces.size() + 1) * rankedFaces.size() / 2;
-
-  uint64_t rank = 1;
-  double offset = 0.0;
-
-  for (const auto& faceInfo : rankedFaces) {
-    double probability = getProbingProbability(rank++, rankSum, rankedFaces.size());
-
-    // Is the random number within the bounds of this face's probability + the previous faces'
-    // probability?
-    //
-    // e.g. (FaceId: 1, p=0.5), (FaceId: 2, p=0.33), (FaceId: 3, p=0.17)
-    //      randomNumber = 0.92
-    //
-    //      The face with FaceId: 3 should be picked
-    //      (0.68 < 0.5 + 0.33 + 0.17) == true
-    //
-    if (randomNumber <= offset + probability) {
-      // Found face to probe
-      return faceInfo.face;
-    }
-    offset += probability;
-  }
-
-  // Given a set of Faces, this method should always select a Face to probe
-  NDN_CXX_UNREACHABLE;
-}
 
-double
-ProbingModule::getProbingProbability(uint64_t rank, uint64_t rankSum, uint64_t nFaces)
-{
-  // p = n + 1 - j ; n: # faces
-  //     ---------
-  //     sum(ranks)
-  return static_cast<double>(nFaces + 1 - rank) / rankSum;
+  // Draw the rank first, then only order the faces enough to find it
+  //
+  // e.g. (FaceId: 1, p=0.5), (FaceId: 2, p=0.33), (FaceId: 3, p=0.17)
+  //      randomNumber = 0.92
+  //
+  //      The face with FaceId: 3 should be picked
+  //      (0.68 < 0.5 + 0.33 + 0.17) == true
+  //
+  size_t rank = drawProbingRank(rankedFaces.size(), randomNumber);
+  Face* face = selectRankedFace(rankedFaces, rank);
+  NFD_LOG_DEBUG("Probing rank " << rank << " of " << rankedFaces.size() << ": face " << face->getId());
+  return face;
 }
 
 void
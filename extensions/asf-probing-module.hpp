@@ -46,22 +46,25 @@ public:
   void
   scheduleProbe(const fib::Entry& fibEntry, time::milliseconds interval);
 
+  /** \note \p info is the NamespaceInfo of the Interest, which the strategy
+   *        looked up once for all its helpers
+   */
   std::vector<Face*>
   getUnprobedFaces(const Face& inFace,
                    const Interest& interest,
                    const fib::Entry& fibEntry,
-                   const NamespaceInfo::BestPrefixFace& faceContest);
+                   NamespaceInfo& info);
   std::vector<Face*>
   getFacesToProbe(const Face& inFace, const Interest& interest,
                  const fib::Entry& fibEntry,
-                 const NamespaceInfo::BestPrefixFace& faceContest,
+                 NamespaceInfo& info,
                  bool getTimedOutOrNackedFace = false);
 
   bool
-  isProbingNeeded(const fib::Entry& fibEntry, const Interest& interest);
+  isProbingNeeded(const fib::Entry& fibEntry, NamespaceInfo& info);
 
   void
-  afterForwardingProbe(const fib::Entry& fibEntry, const Interest& interest);
+  afterForwardingProbe(const fib::Entry& fibEntry, NamespaceInfo& info);
 
   void
   setProbingInterval(size_t probingInterval);
@@ -74,10 +77,7 @@ public:
 
 private:
   static Face*
-  chooseFace(const std::set<FaceStats, FaceStatsCompare>& rankedFaces);
-
-  static double
-  getProbingProbability(uint64_t rank, uint64_t rankSum, uint64_t nFaces);
+  chooseFace(RankedFaces& rankedFaces);
 
 public:
   static constexpr time::milliseconds DEFAULT_PROBING_INTERVAL = 1_min;
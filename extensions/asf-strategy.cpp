@@ -27,8 +27,8 @@
 #include "algorithm.hpp"
 #include "common/global.hpp"
 #include "common/logger.hpp"
+#include <ndn-cxx/util/random.hpp>
 #include <iostream>
-#include <boost/date_time/posix_time/posix_time.hpp>
 
 namespace nfd {
 namespace fw {
@@ -60,7 +60,10 @@ MAsfStrategy::MAsfStrategy(Forwarder& forwarder, const Name& name)
   this->setInstanceName(makeInstanceName(name, getStrategyName()));
 
   NFD_LOG_DEBUG("probing-interval=" << m_probing.getProbingInterval()
-                << " n-silent-timeouts=" << m_nMaxSilentTimeouts);
+                << " n-silent-timeouts=" << m_nMaxSilentTimeouts
+                << " contest-threshold=" << m_faceContest.getThreshold()
+                << " contest-margin=" << m_faceContest.getMargin()
+                << " multipath=" << m_nMultipathFaces);
 }
 
 const Name&
@@ -102,35 +105,45 @@ MAsfStrategy::processParams(const PartialName& parsed)
     else if (f == "n-silent-timeouts") {
       m_nMaxSilentTimeouts = getParamValue(f, s);
     }
+    else if (f == "multipath") {
+      m_nMultipathFaces = getParamValue(f, s);
+    }
+    else if (f == "contest-threshold") {
+      m_faceContest.setThreshold(time::milliseconds(getParamValue(f, s)));
+    }
+    else if (f == "contest-margin") {
+      // percent of the primary face's SRTT
+      m_faceContest.setMargin(getParamValue(f, s) / 100.0);
+    }
     else {
-      NDN_THROW(std::invalid_argument("Parameter should be probing-interval or n-silent-timeouts"));
+      NDN_THROW(std::invalid_argument("Parameter should be probing-interval, n-silent-timeouts, "
+                                      "multipath, contest-threshold or contest-margin"));
     }
   }
 }
 
 void
-MAsfStrategy::exploreAlternateFaces(Face* primaryFace, const FaceEndpoint& ingress, const Interest& interest,
-                                   const fib::Entry& fibEntry, const shared_ptr<pit::Entry>& pitEntry)
+MAsfStrategy::exploreAlternateFaces(const InterestContext& ctx, Face* primaryFace)
 {
-  forwardInterest(interest, *primaryFace, fibEntry, pitEntry);
+  const FaceEndpoint& ingress = ctx.ingress;
+  forwardInterest(ctx, *primaryFace);
 
   //Explore an alternate face.
   Face* altFace = primaryFace;
   time::steady_clock::TimePoint oldestTime = time::steady_clock::now();
-  for (const fib::NextHop& hop : fibEntry.getNextHops())
+  for (const fib::NextHop& hop : ctx.fibEntry.getNextHops())
   {
     Face& hopFace = hop.getFace();
     // Don't send probe Interest back to the incoming face or use the same face
     // as the forwarded Interest or use a face that violates scope
     if (primaryFace->getId() == hopFace.getId() ||
         hopFace.getId() == ingress.face.getId() ||
-        wouldViolateScope(ingress.face, interest, hopFace))
+        wouldViolateScope(ingress.face, ctx.interest, hopFace))
     {
       continue;
     }
 
-    NamespaceInfo* namespaceInfo = m_measurements.getNamespaceInfo(pitEntry->getName());
-    FaceInfo* faceInfo = namespaceInfo->getFaceInfo(hopFace.getId());
+    FaceInfo* faceInfo = ctx.nsInfo.getFaceInfo(hopFace.getId());
     if (faceInfo != nullptr)
     {
       NFD_LOG_TRACE("Face info exists for " << hopFace.getId());
@@ -138,7 +151,7 @@ MAsfStrategy::exploreAlternateFaces(Face* primaryFace, const FaceEndpoint& ingre
       {
         //Try all unprobed faces.
         NFD_LOG_TRACE("Forwarding to unprobed face " << hopFace.getId());
-        forwardInterest(interest, hopFace, fibEntry, pitEntry);
+        forwardInterest(ctx, hopFace);
       }
       else
       {
@@ -155,14 +168,14 @@ MAsfStrategy::exploreAlternateFaces(Face* primaryFace, const FaceEndpoint& ingre
     {
       //Treat as an unprobed face
       NFD_LOG_TRACE("Forwarding to face with no info " << hopFace.getId());
-      forwardInterest(interest, hopFace, fibEntry, pitEntry, true);
+      forwardInterest(ctx, hopFace, true);
     }
   }
 
   if(altFace->getId() != primaryFace->getId())
   {
     NFD_LOG_TRACE("Forwarding to oldest timed out or nacked face " << altFace->getId());
-    forwardInterest(interest, *altFace, fibEntry, pitEntry, true);
+    forwardInterest(ctx, *altFace, true);
   }
 }
 
@@ -170,8 +183,6 @@ void
 MAsfStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Interest& interest,
                                   const shared_ptr<pit::Entry>& pitEntry)
 {
-  NamespaceInfo* namespaceInfo = m_measurements.getNamespaceInfo(pitEntry->getName());
-
   // Should the Interest be suppressed?
   auto suppressResult = m_retxSuppression.decidePerPitEntry(*pitEntry);
   if (suppressResult == RetxSuppressionResult::SUPPRESS) {
@@ -190,8 +201,12 @@ MAsfStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Interest&
     return;
   }
 
+  // The only measurements table lookup for this Interest
+  InterestContext ctx{ingress, interest, fibEntry, pitEntry,
+                      m_measurements.getOrCreateNamespaceInfo(fibEntry, interest)};
+
   //Get the best face and check to see if it's a good face.
-  Face* faceToUse = getBestFaceForForwarding(interest, ingress.face, fibEntry, pitEntry);
+  Face* faceToUse = getBestFaceForForwarding(ctx);
   if (faceToUse == nullptr) {
     NFD_LOG_DEBUG(interest << " interest from=" << ingress << " no-nexthop");
     if (suppressResult == RetxSuppressionResult::NEW) {
@@ -200,32 +215,52 @@ MAsfStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Interest&
     return;
   }
 
-  FaceInfo* faceInfo = m_measurements.getFaceInfo(fibEntry, interest, faceToUse->getId());
-  
+  FaceInfo* faceInfo = ctx.bestFaceInfo;
+
 	if (faceInfo != nullptr && faceInfo->getLastRtt() != FaceInfo::RTT_NO_MEASUREMENT) {
     NFD_LOG_DEBUG("Need to update face change status. Topface: " << faceToUse->getId() );
-    updateFaceChangeStats(faceToUse, interest);
+    m_faceContest.update(ctx.nsInfo, *faceToUse, *faceInfo);
   }
 
   //Check if the retrieved face is working and measured, explore if not
   if (faceInfo != nullptr && faceInfo->getLastRtt() != FaceInfo::RTT_TIMEOUT
       && faceInfo->getLastRtt() != FaceInfo::RTT_NO_MEASUREMENT
       && !faceInfo->isNacked()) {
-    NamespaceInfo::BestPrefixFace* faceContest = namespaceInfo->getFaceContest();
+    Face* splitFace = nullptr;
+    if (m_nMultipathFaces > 1) {
+      splitFace = getMultipathFace(ctx, suppressResult == RetxSuppressionResult::FORWARD);
+    }
+    if (splitFace != nullptr) {
+      NFD_LOG_DEBUG("Load splitting. Send to face: " << splitFace->getId());
+      forwardInterest(ctx, *splitFace);
+      sendProbe(ctx);
+      return;
+    }
+
+    NamespaceInfo::BestPrefixFace* faceContest = ctx.nsInfo.getFaceContest();
 
     NFD_LOG_DEBUG("Send to primary face: " << faceContest->primaryFace->getId());
-    forwardInterest(interest, *(faceContest->primaryFace), fibEntry, pitEntry);
+    forwardInterest(ctx, *(faceContest->primaryFace));
 
     if (faceContest->contest) {
       NFD_LOG_DEBUG("Face contest is on. Also send to current top face: " << faceToUse->getId());
-      forwardInterest(interest, *faceToUse, fibEntry, pitEntry, true);
+      forwardInterest(ctx, *faceToUse, true);
     }
 		// If necessary, send probe- checks if due in sendProbe
-    sendProbe(interest, ingress, *faceToUse, fibEntry, pitEntry);
+    sendProbe(ctx);
+  }
+  else if ((faceInfo == nullptr || faceInfo->getLastRtt() == FaceInfo::RTT_NO_MEASUREMENT)
+           && suppressResult == RetxSuppressionResult::NEW) {
+    // Measured faces rank first and timed-out or nacked ones last, so no face has
+    // an RTT sample yet: go by the routing cost, the top face having the lowest FIB
+    // cost, rather than multicast. A face that fails ranks below the unmeasured ones,
+    // and the next Interest tries the next lowest cost.
+    NFD_LOG_DEBUG("No RTT sample yet. Send to lowest-cost face: " << faceToUse->getId());
+    forwardInterest(ctx, *faceToUse);
   }
   else {
     NFD_LOG_DEBUG("Top face does not have measurement or timed-out or nacked. Need to explore alternate faces.");
-    exploreAlternateFaces(faceToUse, ingress, interest, fibEntry, pitEntry);
+    exploreAlternateFaces(ctx, faceToUse);
   }
 }
 
@@ -251,6 +286,7 @@ MAsfStrategy::beforeSatisfyInterest(const shared_ptr<pit::Entry>& pitEntry,
     NFD_LOG_DEBUG(pitEntry->getName() << " data from=" << ingress << " no-out-record");
   }
   else {
+    faceInfo->removeInFlight();
     faceInfo->recordRtt(time::steady_clock::now() - outRecord->getLastRenewed());
     NFD_LOG_DEBUG(pitEntry->getName() << " data from=" << ingress
                   << " rtt=" << faceInfo->getLastRtt() << " srtt=" << faceInfo->getSrtt());
@@ -272,9 +308,10 @@ MAsfStrategy::afterReceiveNack(const FaceEndpoint& ingress, const lp::Nack& nack
 }
 
 void
-MAsfStrategy::forwardInterest(const Interest& interest, Face& outFace, const fib::Entry& fibEntry,
-                             const shared_ptr<pit::Entry>& pitEntry, bool wantNewNonce)
+MAsfStrategy::forwardInterest(const InterestContext& ctx, Face& outFace, bool wantNewNonce)
 {
+  const Interest& interest = ctx.interest;
+  const shared_ptr<pit::Entry>& pitEntry = ctx.pitEntry;
   auto egress = FaceEndpoint(outFace, 0);
   if (wantNewNonce) {
     // Send probe: interest with new Nonce
@@ -287,130 +324,112 @@ MAsfStrategy::forwardInterest(const Interest& interest, Face& outFace, const fib
     this->sendInterest(pitEntry, egress, interest);
   }
 
-  FaceInfo& faceInfo = m_measurements.getOrCreateFaceInfo(fibEntry, interest, egress.face.getId());
+  FaceInfo& faceInfo = ctx.nsInfo.getOrCreateFaceInfo(egress.face.getId());
   faceInfo.markLastTimeForwarded();
 
   // Refresh measurements since Face is being used for forwarding
-  NamespaceInfo& namespaceInfo = m_measurements.getOrCreateNamespaceInfo(fibEntry, interest);
-  namespaceInfo.extendFaceInfoLifetime(faceInfo, egress.face.getId());
+  ctx.nsInfo.extendFaceInfoLifetime(faceInfo, egress.face.getId());
+  faceInfo.addInFlight();
 
   if (!faceInfo.isTimeoutScheduled()) {
     auto timeout = faceInfo.scheduleTimeout(interest.getName(),
       [this, name = interest.getName(), faceId = egress.face.getId()] {
         onTimeoutOrNack(name, faceId, false);
       });
-    NFD_LOG_TRACE("Scheduled timeout for " << fibEntry.getPrefix() << " to=" << egress
+    NFD_LOG_TRACE("Scheduled timeout for " << ctx.fibEntry.getPrefix() << " to=" << egress
                   << " in " << time::duration_cast<time::microseconds>(timeout) << " ms");
   }
 }
 
 void
-MAsfStrategy::sendProbe(const Interest& interest, const FaceEndpoint& ingress, const Face& faceToUse,
-                       const fib::Entry& fibEntry, const shared_ptr<pit::Entry>& pitEntry)
+MAsfStrategy::sendProbe(const InterestContext& ctx)
 {
-  NamespaceInfo::BestPrefixFace* faceContest = m_measurements.getNamespaceInfo(interest.getName())->getFaceContest();
-  if (!m_probing.isProbingNeeded(fibEntry, interest)) {
+  if (!m_probing.isProbingNeeded(ctx.fibEntry, ctx.nsInfo)) {
     NFD_LOG_DEBUG("Probing is not needed.");
 		return;
 	}
-  std::vector<Face*> facesToProbe = m_probing.getFacesToProbe(ingress.face, interest, fibEntry, *faceContest);
+  std::vector<Face*> facesToProbe = m_probing.getFacesToProbe(ctx.ingress.face, ctx.interest,
+                                                              ctx.fibEntry, ctx.nsInfo);
   if (facesToProbe.empty())
     return;
   for (Face* faceToProbe : facesToProbe) {
 		NFD_LOG_DEBUG("Probing Face " << faceToProbe->getId());
-    forwardInterest(interest, *faceToProbe, fibEntry, pitEntry, true);
+    forwardInterest(ctx, *faceToProbe, true);
   }
-  m_probing.afterForwardingProbe(fibEntry, interest);
+  m_probing.afterForwardingProbe(ctx.fibEntry, ctx.nsInfo);
 }
 
-void
-MAsfStrategy::updateFaceChangeStats(Face* topFace, const Interest& interest)
+Face*
+MAsfStrategy::getBestFaceForForwarding(InterestContext& ctx, bool isInterestNew)
 {
-  NamespaceInfo::BestPrefixFace* faceContest = m_measurements.getNamespaceInfo(interest.getName())->getFaceContest();
-  if (faceContest == nullptr) {
-    return;
-  }
-  if (faceContest->primaryFace == nullptr) {
-    NFD_LOG_DEBUG("Primary face is nullptr. Set it to current top face " << topFace->getId());
-    faceContest->primaryFace = topFace;
-    //faceContest->changeTime = boost::posix_time::microsec_clock::local_time();
-
-    return;
-  }
+  // only the top face is needed: keep the best one seen, no ranking container
+  FaceStatsCompare isBetter;
+  FaceStats best{nullptr, FaceInfo::RTT_NO_MEASUREMENT, FaceInfo::RTT_NO_MEASUREMENT, 0, 0};
+  ctx.bestFaceInfo = nullptr;
 
-  //Is initialized?
-  /*if (faceContest == nullptr) {
-    NamespaceInfo::BestPrefixFace temp;
-    temp.primaryFace = topFace;
-    temp.bestFace = nullptr;
-    temp.changeTime = boost::posix_time::microsec_clock::local_time();
-    faceContest = &temp;
-    m_measurements.getNamespaceInfo(interest.getName())->setFaceContest(faceContest);
-    return;
-  }*/
+  auto now = time::steady_clock::now();
+  for (const auto& nh : ctx.fibEntry.getNextHops()) {
+    if (!isNextHopEligible(ctx.ingress.face, ctx.interest, nh, ctx.pitEntry, !isInterestNew, now)) {
+      continue;
+    }
 
-  //If top ranked face not different from current primary face
-  if (topFace == faceContest->primaryFace) {
-    NFD_LOG_DEBUG("Top ranked face (" << topFace->getId() << ") is same as primary face " << faceContest->primaryFace->getId());
-    faceContest->contest = false;
-    return;
-  }
-  ndn::time::steady_clock::duration threshold = boost::chrono::milliseconds(2000);
-  if (faceContest->contest) {
-    ndn::time::system_clock::TimePoint now = ndn::time::system_clock::now();
-    NFD_LOG_DEBUG("Face contest is on. Check if the current top face (" << topFace->getId() << ") has been on top for the threshold time duration.");
-    // TODO: Code style!
-    boost::chrono::milliseconds elapsedTime = boost::chrono::duration_cast<boost::chrono::milliseconds>
-    (now-faceContest->changeTime);
-    if (elapsedTime >= threshold) {
-      NFD_LOG_DEBUG("Changing the primary face from " << faceContest->primaryFace->getId() << " to " << topFace->getId());
-      faceContest->primaryFace = topFace;
-      faceContest->contest = false;
-      faceContest->changeTime = ndn::time::system_clock::now();
+    FaceInfo* info = ctx.nsInfo.getFaceInfo(nh.getFace().getId());
+    FaceStats stats{&nh.getFace(), FaceInfo::RTT_NO_MEASUREMENT,
+                    FaceInfo::RTT_NO_MEASUREMENT, nh.getCost(), 0};
+    if (info != nullptr) {
+      stats.rtt = info->getLastRtt();
+      stats.srtt = info->getSrtt();
+      stats.nInFlight = info->getNInFlight();
     }
-    else {
-      NFD_LOG_DEBUG("Current top face has not been in the top for threshold duration. So don't change primary face.");
+    NFD_LOG_TRACE("Ranking face " << stats.face->getId() << ", rtt: " << stats.rtt
+                  << ", srtt: " << stats.srtt);
+
+    if (best.face == nullptr || isBetter(stats, best)) {
+      best = stats;
+      ctx.bestFaceInfo = info;
     }
   }
-  else {
-    NFD_LOG_DEBUG("Top ranked face (" << topFace->getId() << ") is different than primary face (" << faceContest->primaryFace->getId() << ") . Turn on face contest and store the change time.");
-    faceContest->bestFace = topFace;
-    faceContest->contest = true;
-    faceContest->changeTime = ndn::time::system_clock::now();
+
+  if (best.face != nullptr) {
+    NFD_LOG_DEBUG("Best face for forwarding: " << best.face->getId());
   }
+  return best.face;
 }
 
 Face*
-MAsfStrategy::getBestFaceForForwarding(const Interest& interest, const Face& inFace,
-                                      const fib::Entry& fibEntry, const shared_ptr<pit::Entry>& pitEntry,
-                                      bool isInterestNew)
+MAsfStrategy::getMultipathFace(const InterestContext& ctx, bool isRetransmission)
 {
-  std::set<FaceStats, FaceStatsCompare> rankedFaces;
+  RankedFaces rankedFaces;
+  RankedFaces unusedFaces;
 
   auto now = time::steady_clock::now();
-  for (const auto& nh : fibEntry.getNextHops()) {
-    if (!isNextHopEligible(inFace, interest, nh, pitEntry, !isInterestNew, now)) {
+  for (const auto& nh : ctx.fibEntry.getNextHops()) {
+    if (!isNextHopEligible(ctx.ingress.face, ctx.interest, nh, ctx.pitEntry, false, now)) {
       continue;
     }
 
-    FaceInfo* info = m_measurements.getFaceInfo(fibEntry, interest, nh.getFace().getId());
-    if (info == nullptr) {
-      rankedFaces.insert({&nh.getFace(), FaceInfo::RTT_NO_MEASUREMENT,
-                          FaceInfo::RTT_NO_MEASUREMENT, nh.getCost()});
+    FaceInfo* info = ctx.nsInfo.getFaceInfo(nh.getFace().getId());
+    if (info == nullptr || info->getLastRtt() < time::nanoseconds::zero()) {
+      // not measured, timed out or nacked: left to probing and exploration
+      continue;
     }
-    else {
-      rankedFaces.insert({&nh.getFace(), info->getLastRtt(), info->getSrtt(), nh.getCost()});
+
+    FaceStats stats{&nh.getFace(), info->getLastRtt(), info->getSrtt(), nh.getCost(),
+                    info->getNInFlight()};
+    rankedFaces.push_back(stats);
+    if (isRetransmission && ctx.pitEntry->getOutRecord(nh.getFace()) == ctx.pitEntry->out_end()) {
+      unusedFaces.push_back(stats);
     }
   }
 
-  NFD_LOG_DEBUG("Current ranking of the faces for forwarding: ");
-  auto it1 = rankedFaces.begin();
-  for(; it1 != rankedFaces.end(); it1++) {
-    NFD_LOG_DEBUG("	Faceid: " << it1->face->getId() << ", rtt: " << it1->rtt << ", srtt: " << it1->srtt);
+  RankedFaces& candidates = unusedFaces.empty() ? rankedFaces : unusedFaces;
+  if (candidates.empty()) {
+    return nullptr;
   }
 
-  auto it = rankedFaces.begin();
-  return it != rankedFaces.end() ? it->face : nullptr;
+  static std::uniform_real_distribution<> randDist;
+  return selectWeightedFace(candidates, m_nMultipathFaces,
+                            randDist(ndn::random::getRandomNumberEngine()));
 }
 
 void
@@ -429,6 +448,12 @@ MAsfStrategy::onTimeoutOrNack(const Name& interestName, FaceId faceId, bool isNa
   }
 
   auto& faceInfo = *fiPtr;
+  if (isNack) {
+    faceInfo.removeInFlight();
+  }
+  else {
+    faceInfo.clearInFlight();
+  }
   size_t nTimeouts = faceInfo.getNSilentTimeouts() + 1;
   faceInfo.setNSilentTimeouts(nTimeouts);
 
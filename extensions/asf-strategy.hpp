@@ -26,6 +26,7 @@
 #ifndef NFD_DAEMON_FW_ASF_STRATEGY_HPP
 #define NFD_DAEMON_FW_ASF_STRATEGY_HPP
 
+#include "asf-face-contest.hpp"
 #include "asf-measurements.hpp"
 #include "asf-probing-module.hpp"
 #include "fw/retx-suppression-exponential.hpp"
@@ -46,6 +47,10 @@ namespace asf {
  *       "An Experimental Investigation of Hyperbolic Routing with a Smart Forwarding Plane in NDN,"
  *       NDN Technical Report NDN-0042, 2016. http://named-data.net/techreports.html
  *
+ *  Until a namespace has RTT samples, its Interests go to the next hop of lowest
+ *  FIB cost (the routing protocol's path cost) only; alternate faces are
+ *  explored when that face times out or is nacked, or for retransmissions.
+ *
  *  \note This strategy is not EndpointId-aware.
  */
 class MAsfStrategy : public Strategy
@@ -71,22 +76,43 @@ public: // triggers
                    const shared_ptr<pit::Entry>& pitEntry) override;
 
 private:
+  /** \brief What afterReceiveInterest resolved for one Interest
+   *
+   *  The NamespaceInfo is looked up (and its lifetime extended) once per
+   *  Interest; every helper forwarding or probing it works from here instead
+   *  of matching the measurements table again.
+   */
+  struct InterestContext
+  {
+    const FaceEndpoint& ingress;
+    const Interest& interest;
+    const fib::Entry& fibEntry;
+    const shared_ptr<pit::Entry>& pitEntry;
+    NamespaceInfo& nsInfo;
+    // measurements of the top face of getBestFaceForForwarding, if any
+    FaceInfo* bestFaceInfo = nullptr;
+  };
+
   void
   processParams(const PartialName& parsed);
 
   void
-  forwardInterest(const Interest& interest, Face& outFace, const fib::Entry& fibEntry,
-                  const shared_ptr<pit::Entry>& pitEntry, bool wantNewNonce = false);
+  forwardInterest(const InterestContext& ctx, Face& outFace, bool wantNewNonce = false);
+
   void
-  sendProbe(const Interest& interest, const FaceEndpoint& ingress, const Face& faceToUse,
-            const fib::Entry& fibEntry, const shared_ptr<pit::Entry>& pitEntry);
+  sendProbe(const InterestContext& ctx);
 
   Face*
-  getBestFaceForForwarding(const Interest& interest, const Face& inFace,
-                           const fib::Entry& fibEntry, const shared_ptr<pit::Entry>& pitEntry,
-                           bool isNewInterest = true);
-  void
-  updateFaceChangeStats(Face* topFace, const Interest& interest);
+  getBestFaceForForwarding(InterestContext& ctx, bool isNewInterest = true);
+
+  /** \brief Load splitting: picks one of the m_nMultipathFaces best measured faces,
+   *         weighted by their SRTT and Interests in flight
+   *
+   *  A retransmission goes to a face it was not sent to yet, when there is one.
+   *  \return nullptr if no face is measured
+   */
+  Face*
+  getMultipathFace(const InterestContext& ctx, bool isRetransmission);
 
   void
   onTimeoutOrNack(const Name& interestName, FaceId faceId, bool isNack);
@@ -95,8 +121,7 @@ private:
   sendNoRouteNack(const FaceEndpoint& ingress, const shared_ptr<pit::Entry>& pitEntry);
 
   void
-  exploreAlternateFaces(Face* forwardedFace, const FaceEndpoint& ingress, const Interest& interest,
-                        const fib::Entry& fibEntry, const shared_ptr<pit::Entry>& pitEntry);
+  exploreAlternateFaces(const InterestContext& ctx, Face* forwardedFace);
 private:
   // struct BestPrefixFace
   // {
@@ -106,8 +131,11 @@ private:
   // };
   AsfMeasurements m_measurements;
   ProbingModule m_probing;
+  FaceContest m_faceContest;
   RetxSuppressionExponential m_retxSuppression;
   size_t m_nMaxSilentTimeouts = 0;
+  // load splitting over this many faces, off if less than 2
+  size_t m_nMultipathFaces = 0;
 
 };
 
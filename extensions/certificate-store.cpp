@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "certificate-store.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+void CertificateStore::reload(KeyChain &keyChain, const Name &identity) {
+  std::map<Name, CertPtr> certs;
+  std::map<Name, CertPtr> keys;
+  CertPtr defaultCert;
+
+  security::Identity id = keyChain.getPib().getIdentity(identity);
+  Name defaultKeyName;
+  try {
+    defaultKeyName = id.getDefaultKey().getName();
+  } catch (const security::Pib::Error &) {
+  }
+
+  for (const auto &key : id.getKeys()) {
+    Name defaultCertName;
+    try {
+      defaultCertName = key.getDefaultCertificate().getName();
+    } catch (const security::Pib::Error &) {
+    }
+    for (const auto &cert : key.getCertificates()) {
+      auto certPtr = make_shared<security::v2::Certificate>(cert);
+      certPtr->wireEncode();
+      certs[cert.getName()] = certPtr;
+      if (cert.getName() == defaultCertName) {
+        keys[key.getName()] = certPtr;
+        if (key.getName() == defaultKeyName)
+          defaultCert = certPtr;
+      }
+    }
+  }
+
+  m_certs.swap(certs);
+  m_keys.swap(keys);
+  m_default = defaultCert;
+}
+
+shared_ptr<const security::v2::Certificate>
+CertificateStore::find(const Name &name) const {
+  auto certIt = m_certs.find(name);
+  if (certIt != m_certs.end())
+    return certIt->second;
+
+  auto keyIt = m_keys.find(name);
+  if (keyIt != m_keys.end())
+    return keyIt->second;
+
+  if (m_default != nullptr && name.isPrefixOf(m_default->getName()))
+    return m_default;
+
+  certIt = m_certs.lower_bound(name);
+  if (certIt != m_certs.end() && name.isPrefixOf(certIt->first))
+    return certIt->second;
+  return nullptr;
+}
+
+} // namespace ndvr
+} // namespace ndn
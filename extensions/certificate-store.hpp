@@ -0,0 +1,50 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_CERTIFICATE_STORE_HPP
+#define NDVR_CERTIFICATE_STORE_HPP
+
+#include <map>
+#include <memory>
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/v2/certificate.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/** @brief In-memory copy of the certificates of one identity
+ *
+ * Built from the PIB once (and on reload), so answering a KEY Interest
+ * does not touch the PIB. Certificates are kept already wire-encoded,
+ * Face::put sends them as they are.
+ */
+class CertificateStore {
+public:
+  /** @brief replace the content with every certificate of identity */
+  void reload(KeyChain &keyChain, const Name &identity);
+
+  /** @brief certificate for name, which can be:
+   *  - a certificate name: that certificate
+   *  - a key name (e.g., KeyLocator): the default certificate of the key
+   *  - any other prefix: the first certificate under it (the default
+   *    one if the prefix covers the default key)
+   * @return nullptr if there is none
+   */
+  shared_ptr<const security::v2::Certificate> find(const Name &name) const;
+
+  size_t size() const { return m_certs.size(); }
+
+private:
+  using CertPtr = shared_ptr<const security::v2::Certificate>;
+
+  /* certificate name => certificate */
+  std::map<Name, CertPtr> m_certs;
+  /* key name => default certificate of the key */
+  std::map<Name, CertPtr> m_keys;
+  CertPtr m_default;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_CERTIFICATE_STORE_HPP
@@ -0,0 +1,43 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "crypto-worker-pool.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+CryptoWorkerPool::CryptoWorkerPool(size_t nThreads) {
+  if (nThreads == 0)
+    return;
+
+  m_work.reset(new boost::asio::io_service::work(m_io));
+  for (size_t i = 0; i < nThreads; ++i) {
+    m_threads.emplace_back([this] { m_io.run(); });
+  }
+}
+
+CryptoWorkerPool::~CryptoWorkerPool() {
+  /* pending jobs are dropped, completions would find no event loop */
+  m_work.reset();
+  m_io.stop();
+  for (auto &t : m_threads) {
+    t.join();
+  }
+}
+
+void CryptoWorkerPool::post(boost::asio::io_service &resultIo,
+                            std::function<void()> job,
+                            std::function<void()> done) {
+  if (m_threads.empty()) {
+    job();
+    done();
+    return;
+  }
+
+  m_io.post([&resultIo, job, done] {
+    job();
+    resultIo.post(done);
+  });
+}
+
+} // namespace ndvr
+} // namespace ndn
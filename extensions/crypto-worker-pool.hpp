@@ -0,0 +1,49 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_CRYPTO_WORKER_POOL_HPP
+#define NDVR_CRYPTO_WORKER_POOL_HPP
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <ndn-cxx/util/noncopyable.hpp>
+
+// boost needs to be included after ndn-cxx, otherwise there will be conflict with _1, _2, ...
+#include <boost/asio/io_service.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/** @brief Threads that run signing/verification off the Face event loop
+ *
+ * post() runs the job on a worker thread and then posts the completion
+ * handler to the io_service of the Face, so every handler still runs
+ * on the (single) event-loop thread and Ndvr needs no locking: only
+ * the job itself must be thread-safe (see DvInfoSigner).
+ *
+ * With zero threads job and completion run inline, in the caller, which
+ * is what ndnSIM needs (no threads allowed in the simulator).
+ */
+class CryptoWorkerPool : noncopyable {
+public:
+  explicit CryptoWorkerPool(size_t nThreads);
+
+  ~CryptoWorkerPool();
+
+  void post(boost::asio::io_service &resultIo, std::function<void()> job,
+            std::function<void()> done);
+
+  size_t getNThreads() const { return m_threads.size(); }
+
+private:
+  boost::asio::io_service m_io;
+  std::unique_ptr<boost::asio::io_service::work> m_work;
+  std::vector<std::thread> m_threads;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_CRYPTO_WORKER_POOL_HPP
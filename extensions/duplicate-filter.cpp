@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "duplicate-filter.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace ndvr {
+
+/* 64-bit FNV-1a */
+static uint64_t hashBytes(const uint8_t *data, size_t size, uint64_t h) {
+  for (size_t i = 0; i < size; ++i) {
+    h ^= data[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+/* final mix of MurmurHash3, to derive the second hash */
+static uint64_t mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+DuplicateFilter::DuplicateFilter(size_t expectedEntries,
+                                 time::nanoseconds window)
+    : m_window(window),
+      /* ~9.6 bits per entry for 1% with the optimal number of hashes (7) */
+      m_nBits(std::max<size_t>(64, expectedEntries * 10)),
+      m_current((m_nBits + 63) / 64), m_previous((m_nBits + 63) / 64),
+      m_rotated(time::steady_clock::now()) {}
+
+void DuplicateFilter::rotate(time::steady_clock::TimePoint now) {
+  if (now - m_rotated < m_window)
+    return;
+  if (now - m_rotated < 2 * m_window)
+    m_previous.swap(m_current);
+  else
+    std::fill(m_previous.begin(), m_previous.end(), 0);
+  std::fill(m_current.begin(), m_current.end(), 0);
+  m_rotated = now;
+}
+
+bool DuplicateFilter::test(const std::vector<uint64_t> &bits, uint64_t h1,
+                           uint64_t h2) const {
+  for (int i = 0; i < kHashes; ++i) {
+    size_t bit = (h1 + i * h2) % m_nBits;
+    if (!(bits[bit / 64] & (uint64_t(1) << (bit % 64))))
+      return false;
+  }
+  return true;
+}
+
+bool DuplicateFilter::isDuplicate(const uint8_t *name, size_t nameSize,
+                                  uint32_t nonce) {
+  rotate(time::steady_clock::now());
+
+  uint8_t nonceBytes[4] = {uint8_t(nonce >> 24), uint8_t(nonce >> 16),
+                           uint8_t(nonce >> 8), uint8_t(nonce)};
+  uint64_t h1 = hashBytes(name, nameSize, 0xcbf29ce484222325ULL);
+  h1 = hashBytes(nonceBytes, sizeof(nonceBytes), h1);
+  /* non-zero, so that the kHashes probes differ */
+  uint64_t h2 = mix(h1) | 1;
+
+  bool seen = test(m_current, h1, h2) || test(m_previous, h1, h2);
+  for (int i = 0; i < kHashes; ++i) {
+    size_t bit = (h1 + i * h2) % m_nBits;
+    m_current[bit / 64] |= uint64_t(1) << (bit % 64);
+  }
+  return seen;
+}
+
+} // namespace ndvr
+} // namespace ndn
@@ -0,0 +1,51 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_DUPLICATE_FILTER_HPP
+#define NDVR_DUPLICATE_FILTER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <ndn-cxx/util/time.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/** @brief Time-windowed Bloom filter of (name, nonce) pairs
+ *
+ * Recognizes the Interests received again over another path of a
+ * broadcast medium. Hellos have a zero lifetime, so NFD's dead nonce list
+ * does not catch them. Two filters of one window each are kept, the
+ * current one and the previous one, so a pair is remembered for one to
+ * two windows. Sized for expectedEntries pairs per window at ~1% false
+ * positives: a false positive drops an Interest that the sender will
+ * repeat anyway (next hello, DvInfo retransmission).
+ */
+class DuplicateFilter {
+public:
+  explicit DuplicateFilter(size_t expectedEntries = 1024,
+                           time::nanoseconds window = time::seconds(1));
+
+  /** @brief records the pair and tells whether it was seen in the window
+   * @param name the TLV wire encoding of the name */
+  bool isDuplicate(const uint8_t *name, size_t nameSize, uint32_t nonce);
+
+private:
+  void rotate(time::steady_clock::TimePoint now);
+
+  bool test(const std::vector<uint64_t> &bits, uint64_t h1, uint64_t h2) const;
+
+private:
+  static const int kHashes = 7;
+
+  time::nanoseconds m_window;
+  size_t m_nBits;
+  std::vector<uint64_t> m_current;
+  std::vector<uint64_t> m_previous;
+  time::steady_clock::TimePoint m_rotated;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_DUPLICATE_FILTER_HPP
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "dvinfo-signer.hpp"
+
+#include <ndn-cxx/encoding/buffer-stream.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/security/transform/buffer-source.hpp>
+#include <ndn-cxx/security/transform/hmac-filter.hpp>
+#include <ndn-cxx/security/transform/private-key.hpp>
+#include <ndn-cxx/security/transform/stream-sink.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace ndn {
+namespace ndvr {
+
+ConstBufferPtr hmacSha256(const Buffer &key, const uint8_t *buf,
+                          size_t size) {
+  security::transform::PrivateKey hmacKey;
+  hmacKey.loadRaw(KeyType::HMAC, key.data(), key.size());
+
+  OBufferStream os;
+  security::transform::bufferSource(buf, size) >>
+      security::transform::hmacFilter(DigestAlgorithm::SHA256, hmacKey) >>
+      security::transform::streamSink(os);
+  return os.buf();
+}
+
+HmacDvInfoSigner::HmacDvInfoSigner(const Name &network,
+                                   const std::string &secret,
+                                   time::seconds rotationInterval)
+    : m_keyPrefix(Name(network).append("ndvr").append("hmac")),
+      m_secret(secret.data(), secret.size()),
+      m_rotationInterval(rotationInterval) {
+  if (m_secret.empty())
+    throw std::invalid_argument("HMAC network secret is empty");
+  if (m_rotationInterval <= time::seconds::zero())
+    throw std::invalid_argument("HMAC rotation interval must be positive");
+}
+
+uint64_t HmacDvInfoSigner::getCurrentEpoch() const {
+  return time::toUnixTimestamp(time::system_clock::now()).count() /
+         time::duration_cast<time::milliseconds>(m_rotationInterval).count();
+}
+
+ConstBufferPtr HmacDvInfoSigner::getKey(uint64_t epoch) {
+  std::lock_guard<std::mutex> lock(m_keysMutex);
+  auto it = m_keys.find(epoch);
+  if (it != m_keys.end())
+    return it->second;
+
+  /* keys older than the previous epoch will not be used anymore */
+  uint64_t current = getCurrentEpoch();
+  m_keys.erase(m_keys.begin(),
+               m_keys.lower_bound(current > 0 ? current - 1 : 0));
+
+  const Block &keyName = getKeyName(epoch).wireEncode();
+  auto key = hmacSha256(m_secret, keyName.wire(), keyName.size());
+  m_keys[epoch] = key;
+  return key;
+}
+
+void HmacDvInfoSigner::sign(Data &data) {
+  uint64_t epoch = getCurrentEpoch();
+  auto key = getKey(epoch);
+
+  data.setSignatureInfo(SignatureInfo(tlv::SignatureHmacWithSha256,
+                                      KeyLocator(getKeyName(epoch))));
+
+  EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+  auto signature = hmacSha256(*key, encoder.buf(), encoder.size());
+  data.wireEncode(encoder, Block(tlv::SignatureValue, signature));
+}
+
+bool HmacDvInfoSigner::canVerify(const Data &data) const {
+  return data.getSignatureInfo().getSignatureType() ==
+         tlv::SignatureHmacWithSha256;
+}
+
+bool HmacDvInfoSigner::verify(const Data &data) {
+  /* same checks the validator would do with a rule: the KeyLocator must
+   * be the HMAC key name of this network for a recent epoch */
+  const auto &sigInfo = data.getSignatureInfo();
+  if (!canVerify(data) || !sigInfo.hasKeyLocator() ||
+      sigInfo.getKeyLocator().getType() != tlv::Name)
+    return false;
+  const Name &keyName = sigInfo.getKeyLocator().getName();
+  if (keyName.size() != m_keyPrefix.size() + 1 ||
+      !m_keyPrefix.isPrefixOf(keyName) || !keyName.get(-1).isNumber())
+    return false;
+  uint64_t epoch = keyName.get(-1).toNumber();
+  uint64_t current = getCurrentEpoch();
+  if (epoch + 1 < current || epoch > current + 1)
+    return false;
+
+  /* signed portion: from Name up to (excluding) SignatureValue */
+  Block wire = data.wireEncode();
+  wire.parse();
+  auto sigValue = wire.find(tlv::SignatureValue);
+  if (sigValue == wire.elements_end())
+    return false;
+  auto expected =
+      hmacSha256(*getKey(epoch), wire.value(), sigValue->wire() - wire.value());
+  if (expected->size() != sigValue->value_size())
+    return false;
+
+  uint8_t diff = 0;
+  for (size_t i = 0; i < expected->size(); ++i)
+    diff |= (*expected)[i] ^ sigValue->value()[i];
+  return diff == 0;
+}
+
+std::unique_ptr<DvInfoSigner>
+makeDvInfoSigner(const std::string &mode, KeyChain &keyChain,
+                 const security::SigningInfo &signingInfo,
+                 const Name &network, const std::string &hmacKeyFile,
+                 time::seconds hmacRotationInterval) {
+  if (mode.empty() || mode == "ecdsa")
+    return std::unique_ptr<DvInfoSigner>(
+        new KeyChainDvInfoSigner(keyChain, signingInfo));
+
+  if (mode == "hmac") {
+    std::ifstream is(hmacKeyFile, std::ios::binary);
+    if (!is)
+      throw std::runtime_error("Cannot open HMAC key file " + hmacKeyFile);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return std::unique_ptr<DvInfoSigner>(
+        new HmacDvInfoSigner(network, ss.str(), hmacRotationInterval));
+  }
+
+  throw std::invalid_argument("Unknown DvInfo signing mode: " + mode);
+}
+
+} // namespace ndvr
+} // namespace ndn
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_DVINFO_SIGNER_HPP
+#define NDVR_DVINFO_SIGNER_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/encoding/buffer.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/signing-info.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/** @brief Signing scheme used for DvInfo replies
+ *
+ * A signer may also verify DvInfo Data by itself (canVerify), in which
+ * case the Ndvr validator (ValidatorConfig) is not consulted. That is
+ * the case for schemes ndn-cxx's validator does not support, such as
+ * the shared-key HMAC mode.
+ *
+ * sign() and verify() may be called from CryptoWorkerPool threads, so
+ * implementations must be thread-safe.
+ */
+class DvInfoSigner {
+public:
+  virtual ~DvInfoSigner() = default;
+
+  virtual void sign(Data &data) = 0;
+
+  /** @brief true if data is signed with this scheme and must be
+   * checked with verify() instead of the validator */
+  virtual bool canVerify(const Data &data) const { return false; }
+
+  virtual bool verify(const Data &data) { return false; }
+
+  virtual std::string getName() const = 0;
+};
+
+/** @brief Default scheme: router's asymmetric key (ECDSA), certified by
+ * the network key and checked with the rules in validation.conf
+ *
+ * KeyChain is not thread-safe: signing is serialized here, but when
+ * signing runs on worker threads the KeyChain given to this signer must
+ * not be used by the event loop (NdvrRunner opens a second one).
+ */
+class KeyChainDvInfoSigner : public DvInfoSigner {
+public:
+  KeyChainDvInfoSigner(KeyChain &keyChain,
+                       const security::SigningInfo &signingInfo)
+      : m_keyChain(keyChain), m_signingInfo(signingInfo) {}
+
+  void sign(Data &data) override {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_keyChain.sign(data, m_signingInfo);
+  }
+
+  std::string getName() const override { return "ecdsa"; }
+
+private:
+  KeyChain &m_keyChain;
+  const security::SigningInfo &m_signingInfo;
+  std::mutex m_mutex;
+};
+
+/** @brief HMAC-SHA256 with a key shared by all routers of a network
+ *
+ * Meant for closed networks where every router is provisioned with the
+ * same network secret; it trades per-router authentication (any member
+ * can sign for any router) for a much cheaper sign/verify than ECDSA.
+ *
+ * Time is divided in epochs of rotationInterval. The key of an epoch is
+ *    HMAC-SHA256(secret, <network>/ndvr/hmac/<epoch>)
+ * and that name is also the KeyLocator of the DvInfo, so the receiver
+ * knows which key to use. Keys of the previous and next epoch are
+ * accepted to tolerate clock skew around the rotation.
+ */
+class HmacDvInfoSigner : public DvInfoSigner {
+public:
+  HmacDvInfoSigner(const Name &network, const std::string &secret,
+                   time::seconds rotationInterval = time::hours(1));
+
+  void sign(Data &data) override;
+
+  bool canVerify(const Data &data) const override;
+
+  bool verify(const Data &data) override;
+
+  std::string getName() const override { return "hmac"; }
+
+  Name getKeyName(uint64_t epoch) const {
+    return Name(m_keyPrefix).appendNumber(epoch);
+  }
+
+private:
+  uint64_t getCurrentEpoch() const;
+
+  ConstBufferPtr getKey(uint64_t epoch);
+
+private:
+  Name m_keyPrefix;
+  Buffer m_secret;
+  time::seconds m_rotationInterval;
+  /* epoch => derived key */
+  std::map<uint64_t, ConstBufferPtr> m_keys;
+  std::mutex m_keysMutex;
+};
+
+/** @brief HMAC-SHA256 (RFC 2104), with ndn-cxx's HmacFilter */
+ConstBufferPtr hmacSha256(const Buffer &key, const uint8_t *buf, size_t size);
+
+/** @brief Creates the signer for mode "ecdsa" or "hmac"
+ *
+ * For hmac, hmacKeyFile holds the network secret (raw bytes).
+ */
+std::unique_ptr<DvInfoSigner>
+makeDvInfoSigner(const std::string &mode, KeyChain &keyChain,
+                 const security::SigningInfo &signingInfo,
+                 const Name &network, const std::string &hmacKeyFile,
+                 time::seconds hmacRotationInterval);
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_DVINFO_SIGNER_HPP
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "flap-damping.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ndn {
+namespace ndvr {
+
+void FlapDamping::setParams(const Params &params) {
+  m_params = params;
+  m_maxPenalty =
+      m_params.reuseThreshold *
+      std::exp2(static_cast<double>(m_params.maxSuppressTime.count()) /
+                m_params.halfLife.count());
+}
+
+bool FlapDamping::addFlap(const std::string &name) {
+  if (m_params.flapPenalty <= 0)
+    return false;
+
+  auto now = time::steady_clock::now();
+  auto it = m_entries.find(name);
+  if (it == m_entries.end()) {
+    it = m_entries.emplace(name, Entry()).first;
+    it->second.updated = now;
+  }
+  Entry &entry = it->second;
+  decay(name, entry, now);
+  entry.penalty = std::min(entry.penalty + m_params.flapPenalty, m_maxPenalty);
+  if (entry.penalty >= m_params.suppressThreshold)
+    entry.suppressed = true;
+  return entry.suppressed;
+}
+
+bool FlapDamping::isSuppressed(const std::string &name) {
+  auto it = m_entries.find(name);
+  if (it == m_entries.end())
+    return false;
+  decay(name, it->second, time::steady_clock::now());
+  return it->second.suppressed;
+}
+
+double FlapDamping::getPenalty(const std::string &name) {
+  auto it = m_entries.find(name);
+  if (it == m_entries.end())
+    return 0;
+  decay(name, it->second, time::steady_clock::now());
+  return it->second.penalty;
+}
+
+time::nanoseconds FlapDamping::getReuseDelay(const std::string &name) {
+  auto it = m_entries.find(name);
+  if (it == m_entries.end())
+    return time::nanoseconds::zero();
+  decay(name, it->second, time::steady_clock::now());
+  return reuseDelay(it->second);
+}
+
+time::steady_clock::TimePoint FlapDamping::getNextReuse() const {
+  auto next = time::steady_clock::TimePoint::max();
+  for (const auto &item : m_entries) {
+    if (item.second.suppressed)
+      next = std::min(next, item.second.updated + reuseDelay(item.second));
+  }
+  return next;
+}
+
+std::vector<std::string> FlapDamping::expire() {
+  auto now = time::steady_clock::now();
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    decay(it->first, it->second, now);
+    if (!it->second.suppressed &&
+        it->second.penalty < m_params.reuseThreshold / 2)
+      it = m_entries.erase(it);
+    else
+      ++it;
+  }
+  std::vector<std::string> reused;
+  reused.swap(m_reused);
+  return reused;
+}
+
+std::vector<std::string> FlapDamping::getNames() const {
+  std::vector<std::string> names;
+  names.reserve(m_entries.size());
+  for (const auto &item : m_entries)
+    names.push_back(item.first);
+  return names;
+}
+
+void FlapDamping::decay(const std::string &name, Entry &entry,
+                        time::steady_clock::TimePoint now) {
+  if (now > entry.updated) {
+    entry.penalty *=
+        std::exp2(-static_cast<double>((now - entry.updated).count()) /
+                  m_params.halfLife.count());
+    entry.updated = now;
+  }
+  if (entry.suppressed && entry.penalty < m_params.reuseThreshold) {
+    entry.suppressed = false;
+    m_reused.push_back(name);
+  }
+}
+
+time::nanoseconds FlapDamping::reuseDelay(const Entry &entry) const {
+  if (!entry.suppressed || entry.penalty < m_params.reuseThreshold)
+    return time::nanoseconds::zero();
+  return time::nanoseconds(static_cast<time::nanoseconds::rep>(
+      m_params.halfLife.count() *
+      std::log2(entry.penalty / m_params.reuseThreshold)));
+}
+
+} // namespace ndvr
+} // namespace ndn
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_FLAP_DAMPING_HPP
+#define NDVR_FLAP_DAMPING_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/util/time.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/** @brief Thresholds of FlapDamping */
+struct FlapDampingParams {
+  /* 0 disables damping */
+  double flapPenalty = 1000;
+  double suppressThreshold = 2000;
+  double reuseThreshold = 750;
+  /* wireless neighbors come and go within seconds, hence much shorter
+   * than the BGP defaults */
+  time::nanoseconds halfLife = time::seconds(15);
+  time::nanoseconds maxSuppressTime = time::seconds(60);
+};
+
+/** @brief Route flap damping (as in RFC 2439), per name
+ *
+ * Every flap of a name (a neighbor lost, a prefix becoming unreachable)
+ * adds a penalty that decays exponentially with the half-life. Above the
+ * suppress threshold the name is suppressed until its penalty decays
+ * below the reuse threshold. The penalty is capped, so that nothing
+ * stays suppressed for more than the max suppress time. Names whose
+ * penalty is negligible are forgotten by expire().
+ */
+class FlapDamping {
+public:
+  typedef FlapDampingParams Params;
+
+  explicit FlapDamping(const Params &params = Params()) { setParams(params); }
+
+  void setParams(const Params &params);
+
+  const Params &getParams() const { return m_params; }
+
+  /** @brief record a flap of name
+   * @return true if name is suppressed */
+  bool addFlap(const std::string &name);
+
+  bool isSuppressed(const std::string &name);
+
+  /** @brief current (decayed) penalty of name, 0 if unknown */
+  double getPenalty(const std::string &name);
+
+  /** @brief time until name is reused, zero if it is not suppressed */
+  time::nanoseconds getReuseDelay(const std::string &name);
+
+  /** @brief earliest reuse of a suppressed name (max() if none) */
+  time::steady_clock::TimePoint getNextReuse() const;
+
+  /** @brief forget the names whose penalty became negligible
+   * @return the names that were suppressed and are reused now */
+  std::vector<std::string> expire();
+
+  /** @brief names with a penalty, for status reports */
+  std::vector<std::string> getNames() const;
+
+  bool empty() const { return m_entries.empty(); }
+
+  size_t size() const { return m_entries.size(); }
+
+private:
+  struct Entry {
+    double penalty = 0;
+    time::steady_clock::TimePoint updated;
+    bool suppressed = false;
+  };
+
+  /* bring the entry of name to now, noting name in m_reused if the
+   * penalty fell below reuse */
+  void decay(const std::string &name, Entry &entry,
+             time::steady_clock::TimePoint now);
+
+  time::nanoseconds reuseDelay(const Entry &entry) const;
+
+private:
+  Params m_params;
+  /* reaching it, a penalty decays below reuse in maxSuppressTime */
+  double m_maxPenalty = 0;
+  std::map<std::string, Entry> m_entries;
+  /* reused since the last expire() */
+  std::vector<std::string> m_reused;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_FLAP_DAMPING_HPP
@@ -1,6 +1,11 @@
 #include "localhop-strategy.hpp"
+#include "common/global.hpp"
 #include "common/logger.hpp"
 
+#include <ndn-cxx/util/random.hpp>
+
+#include <algorithm>
+
 namespace nfd {
 namespace fw {
 
@@ -11,13 +16,46 @@ NFD_LOG_INIT(LocalhopStrategy);
 const time::milliseconds LocalhopStrategy::RETX_SUPPRESSION_INITIAL(10);
 const time::milliseconds LocalhopStrategy::RETX_SUPPRESSION_MAX(250);
 
+/** @brief Interest waiting for its random assessment delay on ad hoc faces
+ */
+class AdHocAssessment : public StrategyInfo
+{
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 1040;
+  }
+
+  explicit
+  AdHocAssessment(const Interest& interest)
+    : interest(interest)
+  {
+  }
+
+public:
+  Interest interest;
+  std::vector<FaceId> outFaces;
+  scheduler::ScopedEventId event;
+  /* same name Interests received from ad hoc faces during the delay */
+  size_t nOverheard = 0;
+  /* the last assessment suppressed the Interest */
+  bool wasSuppressed = false;
+};
+
 LocalhopStrategy::LocalhopStrategy(Forwarder& forwarder, const Name& name)
   : Strategy(forwarder)
   , m_retxSuppression(RETX_SUPPRESSION_INITIAL,
                       RetxSuppressionExponential::DEFAULT_MULTIPLIER,
                       RETX_SUPPRESSION_MAX)
 {
+  ParsedInstanceName parsed = parseInstanceName(name);
+  if (!parsed.parameters.empty()) {
+    processParams(parsed.parameters);
+  }
   this->setInstanceName(makeInstanceName(name, getStrategyName()));
+
+  NFD_LOG_DEBUG("ad-hoc-delay=" << m_adHocMaxDelay << " ad-hoc-threshold=" << m_adHocThreshold);
 }
 
 const Name&
@@ -27,6 +65,44 @@ LocalhopStrategy::getStrategyName()
   return strategyName;
 }
 
+static uint64_t
+getParamValue(const std::string& param, const std::string& value)
+{
+  try {
+    if (!value.empty() && value[0] == '-')
+      NDN_THROW(boost::bad_lexical_cast());
+
+    return boost::lexical_cast<uint64_t>(value);
+  }
+  catch (const boost::bad_lexical_cast&) {
+    NDN_THROW(std::invalid_argument("Value of " + param + " must be a non-negative integer"));
+  }
+}
+
+void
+LocalhopStrategy::processParams(const PartialName& parsed)
+{
+  for (const auto& component : parsed) {
+    std::string parsedStr(reinterpret_cast<const char*>(component.value()), component.value_size());
+    auto n = parsedStr.find("~");
+    if (n == std::string::npos) {
+      NDN_THROW(std::invalid_argument("Format is <parameter>~<value>"));
+    }
+
+    auto f = parsedStr.substr(0, n);
+    auto s = parsedStr.substr(n + 1);
+    if (f == "ad-hoc-delay") {
+      m_adHocMaxDelay = time::milliseconds(getParamValue(f, s));
+    }
+    else if (f == "ad-hoc-threshold") {
+      m_adHocThreshold = getParamValue(f, s);
+    }
+    else {
+      NDN_THROW(std::invalid_argument("Parameter should be ad-hoc-delay or ad-hoc-threshold"));
+    }
+  }
+}
+
 bool
 my_wouldViolateScope(const Face& inFace, const Interest& interest, const Face& outFace)
 {
@@ -47,6 +123,14 @@ LocalhopStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Intere
   const fib::NextHopList& nexthops = fibEntry.getNextHops();
   NFD_LOG_DEBUG("I: " << interest << " inFaceId=" << ingress.face.getId());
 
+  if (ingress.face.getLinkType() == ndn::nfd::LINK_TYPE_AD_HOC) {
+    auto assessment = pitEntry->getStrategyInfo<AdHocAssessment>();
+    if (assessment != nullptr && assessment->event) {
+      ++assessment->nOverheard;
+      NFD_LOG_DEBUG(interest << " from=" << ingress << " overheard=" << assessment->nOverheard);
+    }
+  }
+
   int nEligibleNextHops = 0;
 
   bool isSuppressed = false;
@@ -73,6 +157,11 @@ LocalhopStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Intere
       continue;
     }
 
+    if (suppressResult == RetxSuppressionResult::NEW &&
+        delayOnAdHocFace(interest, outFace, pitEntry)) {
+      continue;
+    }
+
     this->sendInterest(pitEntry, FaceEndpoint(outFace, 0), interest);
     NFD_LOG_DEBUG(interest << " from=" << ingress << " pitEntry-to=" << outFace.getId());
 
@@ -91,5 +180,72 @@ LocalhopStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Intere
     this->rejectPendingInterest(pitEntry);
   }
 }
+
+bool
+LocalhopStrategy::delayOnAdHocFace(const Interest& interest, Face& outFace,
+                                   const shared_ptr<pit::Entry>& pitEntry)
+{
+  if (m_adHocMaxDelay <= time::milliseconds::zero() ||
+      outFace.getLinkType() != ndn::nfd::LINK_TYPE_AD_HOC ||
+      interest.getInterestLifetime() <= m_adHocMaxDelay) {
+    return false;
+  }
+
+  auto assessment = pitEntry->insertStrategyInfo<AdHocAssessment>(interest).first;
+  if (assessment->wasSuppressed) {
+    // the Data did not come after all: this is a retransmission
+    return false;
+  }
+
+  auto& outFaces = assessment->outFaces;
+  if (std::find(outFaces.begin(), outFaces.end(), outFace.getId()) == outFaces.end()) {
+    outFaces.push_back(outFace.getId());
+  }
+
+  if (!assessment->event) {
+    std::uniform_int_distribution<time::milliseconds::rep> delayDist(0, m_adHocMaxDelay.count());
+    time::milliseconds delay(delayDist(ndn::random::getRandomNumberEngine()));
+    assessment->nOverheard = 0;
+    assessment->event = getScheduler().schedule(delay,
+      [this, pitEntryWeak = weak_ptr<pit::Entry>(pitEntry)] {
+        afterAssessmentDelay(pitEntryWeak);
+      });
+    NFD_LOG_DEBUG(interest << " to=" << outFace.getId() << " assessment-delay=" << delay);
+  }
+  return true;
+}
+
+void
+LocalhopStrategy::afterAssessmentDelay(const weak_ptr<pit::Entry>& pitEntryWeak)
+{
+  auto pitEntry = pitEntryWeak.lock();
+  if (pitEntry == nullptr) {
+    return;
+  }
+  auto assessment = pitEntry->getStrategyInfo<AdHocAssessment>();
+  if (assessment == nullptr) {
+    return;
+  }
+
+  if (pitEntry->getInRecords().empty()) {
+    NFD_LOG_DEBUG(assessment->interest << " satisfied during the assessment delay");
+    return;
+  }
+
+  if (assessment->nOverheard >= m_adHocThreshold) {
+    NFD_LOG_DEBUG(assessment->interest << " overheard=" << assessment->nOverheard
+                  << " suppressed on ad hoc faces");
+    assessment->wasSuppressed = true;
+    return;
+  }
+
+  for (FaceId faceId : assessment->outFaces) {
+    Face* outFace = this->getFace(faceId);
+    if (outFace != nullptr) {
+      this->sendInterest(pitEntry, FaceEndpoint(*outFace, 0), assessment->interest);
+      NFD_LOG_DEBUG(assessment->interest << " pitEntry-to=" << faceId << " after assessment delay");
+    }
+  }
+}
 } // namespace fw
 } // namespace nfd
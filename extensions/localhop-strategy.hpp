@@ -11,6 +11,17 @@ namespace fw {
 
 /** @brief a forwarding strategy similar to scope=LOCALHOP and strategy=Multicast, but
  * enforcing the scope violation validation
+ *
+ * Parameters (/localhost/nfd/strategy/localhop/%FD%01/<param>~<value>/...):
+ *  - ad-hoc-delay~<ms>: on ad hoc faces, a new Interest is sent after a random
+ *    assessment delay of up to this many milliseconds (0, the default, sends at
+ *    once). Neighbors on the same medium often ask for the same name (e.g. the
+ *    DvInfo of a common neighbor); when the node overhears enough of them during
+ *    the delay, it does not send its own and waits for the Data they will bring.
+ *  - ad-hoc-threshold~<n>: Interests overheard that suppress the node's own
+ *    (default 1)
+ * Retransmissions and Interests whose lifetime does not cover the delay (e.g.
+ * hellos) are sent at once.
  */
 class LocalhopStrategy : public Strategy
 {
@@ -24,10 +35,28 @@ public:
   void
   afterReceiveInterest(const FaceEndpoint& ingress, const Interest& interest,
                        const shared_ptr<pit::Entry>& pitEntry) override;
+private:
+  void
+  processParams(const PartialName& parsed);
+
+  /** @brief schedule sending interest to outFace after a random assessment delay,
+   * unless duplicates are overheard meanwhile
+   * @return false if the Interest must be sent at once
+   */
+  bool
+  delayOnAdHocFace(const Interest& interest, Face& outFace,
+                   const shared_ptr<pit::Entry>& pitEntry);
+
+  void
+  afterAssessmentDelay(const weak_ptr<pit::Entry>& pitEntryWeak);
+
 private:
   RetxSuppressionExponential m_retxSuppression;
   static const time::milliseconds RETX_SUPPRESSION_INITIAL;
   static const time::milliseconds RETX_SUPPRESSION_MAX;
+
+  time::milliseconds m_adHocMaxDelay = time::milliseconds::zero();
+  size_t m_adHocThreshold = 1;
 };
 
 } // namespace fw
@@ -0,0 +1,265 @@
+#ifndef _NAMETRIE_H_
+#define _NAMETRIE_H_
+
+#include <boost/utility/string_view.hpp>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace ndn {
+namespace ndvr {
+
+/**
+ * @brief values keyed by name prefix, indexed by name component
+ *
+ *   Keys are name prefixes in URI form ("/ndn/site-1"), split on '/'. Each
+ *   trie node is one name component; nodes of inserted keys hold the
+ *   <key, value> pair. Children are ordered by component, so iteration
+ *   (pre-order) lists a prefix right before the prefixes it covers, and
+ *   those are contiguous. Longest-prefix match and subtree enumeration
+ *   only walk the components of the name, whatever the size of the table.
+ *
+ *   The interface follows std::map where the routing code needs it (find,
+ *   operator[], erase, upper_bound, iteration), but the iteration order is
+ *   component by component, not the string order of the keys.
+ */
+template <typename T> class NameTrie {
+public:
+  typedef std::string key_type;
+  typedef T mapped_type;
+  typedef std::pair<const std::string, T> value_type;
+
+private:
+  struct Node {
+    Node *parent = nullptr;
+    /* key of this node in parent->children */
+    const std::string *component = nullptr;
+    std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+    std::unique_ptr<value_type> entry;
+  };
+
+public:
+  class iterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef NameTrie::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef value_type *pointer;
+    typedef value_type &reference;
+
+    iterator() = default;
+
+    reference operator*() const { return *m_node->entry; }
+    pointer operator->() const { return m_node->entry.get(); }
+
+    iterator &operator++() {
+      m_node = firstEntryFrom(nextNode(m_node));
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    bool operator==(const iterator &other) const {
+      return m_node == other.m_node;
+    }
+    bool operator!=(const iterator &other) const {
+      return m_node != other.m_node;
+    }
+
+  private:
+    explicit iterator(Node *node) : m_node(node) {}
+
+    Node *m_node = nullptr;
+    friend class NameTrie;
+  };
+
+  NameTrie() = default;
+  NameTrie(const NameTrie &) = delete;
+  NameTrie &operator=(const NameTrie &) = delete;
+
+  iterator begin() { return iterator(firstEntryFrom(&m_root)); }
+  iterator end() { return iterator(); }
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  void clear() {
+    m_root.children.clear();
+    m_root.entry.reset();
+    m_size = 0;
+  }
+
+  iterator find(const std::string &key) {
+    Node *node = lookup(key);
+    return iterator(node != nullptr && node->entry ? node : nullptr);
+  }
+
+  T &operator[](const std::string &key) {
+    Node *node = &m_root;
+    forEachComponent(key, [&node](boost::string_view component) {
+      auto it = node->children.find(component);
+      if (it == node->children.end()) {
+        std::unique_ptr<Node> child(new Node);
+        child->parent = node;
+        it = node->children
+                 .emplace(std::string(component.data(), component.size()),
+                          std::move(child))
+                 .first;
+        it->second->component = &it->first;
+      }
+      node = it->second.get();
+      return true;
+    });
+    if (!node->entry) {
+      node->entry.reset(new value_type(key, T()));
+      m_size++;
+    }
+    return node->entry->second;
+  }
+
+  size_t erase(const std::string &key) {
+    Node *node = lookup(key);
+    if (node == nullptr || !node->entry)
+      return 0;
+    node->entry.reset();
+    m_size--;
+    prune(node);
+    return 1;
+  }
+
+  iterator erase(iterator it) {
+    iterator next = std::next(it);
+    it.m_node->entry.reset();
+    m_size--;
+    /* next holds an entry, so it is never pruned */
+    prune(it.m_node);
+    return next;
+  }
+
+  /* first entry after key in iteration order (key need not exist) */
+  iterator upper_bound(const std::string &key) {
+    Node *node = &m_root;
+    Node *after = nullptr;
+    bool found = forEachComponent(
+        key, [&node, &after](boost::string_view component) {
+          auto it = node->children.find(component);
+          if (it != node->children.end()) {
+            node = it->second.get();
+            return true;
+          }
+          /* key would be inserted before the next child, if any */
+          auto next = node->children.upper_bound(component);
+          after = next != node->children.end() ? next->second.get()
+                                               : nextSkippingChildren(node);
+          return false;
+        });
+    if (found)
+      after = nextNode(node);
+    return iterator(firstEntryFrom(after));
+  }
+
+  /* the longest key that is a (component-wise) prefix of name */
+  iterator longestPrefixMatch(const std::string &name) {
+    Node *node = &m_root;
+    Node *match = m_root.entry ? &m_root : nullptr;
+    forEachComponent(name, [&node, &match](boost::string_view component) {
+      auto it = node->children.find(component);
+      if (it == node->children.end())
+        return false;
+      node = it->second.get();
+      if (node->entry)
+        match = node;
+      return true;
+    });
+    return iterator(match);
+  }
+
+  /* prefix (if present) and all the keys it covers, in iteration order */
+  std::pair<iterator, iterator> subtree(const std::string &prefix) {
+    Node *node = lookup(prefix);
+    if (node == nullptr)
+      return {end(), end()};
+    return {iterator(firstEntryFrom(node)),
+            iterator(firstEntryFrom(nextSkippingChildren(node)))};
+  }
+
+private:
+  /* calls f for every component of key, until f returns false;
+   * returns false if it was interrupted */
+  template <typename F>
+  static bool forEachComponent(const std::string &key, F f) {
+    size_t begin = 0;
+    while (begin < key.size()) {
+      if (key[begin] == '/') {
+        begin++;
+        continue;
+      }
+      size_t end = key.find('/', begin);
+      if (end == std::string::npos)
+        end = key.size();
+      if (!f(boost::string_view(key.data() + begin, end - begin)))
+        return false;
+      begin = end;
+    }
+    return true;
+  }
+
+  Node *lookup(const std::string &key) {
+    Node *node = &m_root;
+    bool found = forEachComponent(key, [&node](boost::string_view component) {
+      auto it = node->children.find(component);
+      if (it == node->children.end())
+        return false;
+      node = it->second.get();
+      return true;
+    });
+    return found ? node : nullptr;
+  }
+
+  /* pre-order successor */
+  static Node *nextNode(Node *node) {
+    if (!node->children.empty())
+      return node->children.begin()->second.get();
+    return nextSkippingChildren(node);
+  }
+
+  /* pre-order successor of the last node under node */
+  static Node *nextSkippingChildren(Node *node) {
+    for (; node->parent != nullptr; node = node->parent) {
+      auto &siblings = node->parent->children;
+      auto it = siblings.upper_bound(*node->component);
+      if (it != siblings.end())
+        return it->second.get();
+    }
+    return nullptr;
+  }
+
+  static Node *firstEntryFrom(Node *node) {
+    while (node != nullptr && !node->entry)
+      node = nextNode(node);
+    return node;
+  }
+
+  /* drop the nodes left without entry nor children */
+  void prune(Node *node) {
+    while (node->parent != nullptr && !node->entry && node->children.empty()) {
+      Node *parent = node->parent;
+      parent->children.erase(parent->children.find(*node->component));
+      node = parent;
+    }
+  }
+
+  Node m_root;
+  size_t m_size = 0;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // _NAMETRIE_H_
@@ -17,33 +17,5 @@ AdvertisePrefixCommand::AdvertisePrefixCommand()
   m_responseValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
 }
 
-ListPrefixesCommand::ListPrefixesCommand()
-  : ControlCommand("ndvr", "list")
-{
-  m_requestValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
-  m_responseValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
-}
-
-WatchUpdatesCommand::WatchUpdatesCommand()
-  : ControlCommand("ndvr", "watch")
-{
-  m_requestValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
-  m_responseValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
-}
-
-UnwatchUpdatesCommand::UnwatchUpdatesCommand()
-  : ControlCommand("ndvr", "unwatch")
-{
-  m_requestValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
-  m_responseValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
-}
-
-NeighborsCommand::NeighborsCommand()
-  : ControlCommand("ndvr", "neighbors")
-{
-  m_requestValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
-  m_responseValidator.required(ndn::nfd::CONTROL_PARAMETER_NAME);
-}
-
 } // namespace ndvr
 } // namespace ndn
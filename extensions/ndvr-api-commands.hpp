@@ -6,6 +6,10 @@
 namespace ndn {
 namespace ndvr {
 
+/* Commands of the /localhost/ndvr management API (NdvrApiProcessor).
+ * Use them with nfd::Controller and a CommandOptions prefix of
+ * /localhost, e.g. /localhost/ndvr/advertise/<ControlParameters> */
+
 class WithdrawPrefixCommand : public ndn::nfd::ControlCommand
 {
 public:
@@ -18,30 +22,6 @@ public:
   AdvertisePrefixCommand();
 };
 
-class ListPrefixesCommand : public ndn::nfd::ControlCommand
-{
-public:
-  ListPrefixesCommand();
-};
-
-class WatchUpdatesCommand : public ndn::nfd::ControlCommand
-{
-public:
-  WatchUpdatesCommand();
-};
-
-class UnwatchUpdatesCommand : public ndn::nfd::ControlCommand
-{
-public:
-  UnwatchUpdatesCommand();
-};
-
-class NeighborsCommand : public ndn::nfd::ControlCommand
-{
-public:
-  NeighborsCommand();
-};
-
 } // namespace ndvr
 } // namespace ndn
 
@@ -0,0 +1,315 @@
+#include "ndvr-api-processor.hpp"
+
+#include "ndvr-api-commands.hpp"
+#include "ndvr-status.hpp"
+
+#include "validation-cache.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/mgmt/control-response.hpp>
+#include <ndn-cxx/security/security-common.hpp>
+#include <ndn-cxx/security/v2/certificate-fetcher-offline.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+const ndn::Name NdvrApiProcessor::COMMAND_PREFIX = ndn::Name("/localhost/ndvr");
+const size_t NdvrApiProcessor::MAX_DATASET_ENTRIES = 1000;
+const size_t NdvrApiProcessor::MAX_NOTIFICATION_SIZE = 6000;
+
+const ndn::Name::Component NdvrApiProcessor::ADVERTISE_VERB = ndn::Name::Component("advertise");
+const ndn::Name::Component NdvrApiProcessor::WITHDRAW_VERB  = ndn::Name::Component("withdraw");
+const ndn::Name::Component NdvrApiProcessor::ROUTES_DATASET  = ndn::Name::Component("routes");
+const ndn::Name::Component NdvrApiProcessor::NEIGHBORS_DATASET  = ndn::Name::Component("neighbors");
+const ndn::Name::Component NdvrApiProcessor::DAMPING_DATASET  = ndn::Name::Component("damping");
+const ndn::Name::Component NdvrApiProcessor::ROUTE_EVENTS_STREAM  = ndn::Name::Component("route-events");
+
+/* segments of a routes page stay in the dispatcher's in-memory storage
+ * until the requester fetched them, a few pages at a time */
+static const size_t kApiStorageCapacity = 1024;
+
+NdvrApiProcessor::NdvrApiProcessor(Ndvr& ndvr,
+                                   ndn::Face& face,
+                                   ndn::KeyChain& keyChain,
+                                   const std::string& commandValidationConfig)
+  : m_ndvr(ndvr)
+  // local responses: a digest is enough, and much cheaper for datasets
+  , m_dispatcher(face, keyChain,
+                 ndn::security::SigningInfo(ndn::security::SigningInfo::SIGNER_TYPE_SHA256),
+                 kApiStorageCapacity)
+  , m_scheduler(face.getIoService())
+  , m_commandValidator(make_unique<ndn::security::v2::CertificateFetcherOffline>())
+{
+  if (!commandValidationConfig.empty()) {
+    m_commandValidator.load(getParsedValidationConfig(commandValidationConfig),
+                            commandValidationConfig);
+    m_hasCommandRules = true;
+  }
+
+  m_dispatcher.addControlCommand<ndn::nfd::ControlParameters>(
+    ndn::PartialName().append(ADVERTISE_VERB),
+    makeCommandAuthorization(),
+    &validateParameters<AdvertisePrefixCommand>,
+    [this] (const Name&, const Interest&, const ndn::mgmt::ControlParameters& parameters,
+            const ndn::mgmt::CommandContinuation& done) {
+      queueUpdate(static_cast<const ndn::nfd::ControlParameters&>(parameters), false, done);
+    });
+  m_dispatcher.addControlCommand<ndn::nfd::ControlParameters>(
+    ndn::PartialName().append(WITHDRAW_VERB),
+    makeCommandAuthorization(),
+    &validateParameters<WithdrawPrefixCommand>,
+    [this] (const Name&, const Interest&, const ndn::mgmt::ControlParameters& parameters,
+            const ndn::mgmt::CommandContinuation& done) {
+      queueUpdate(static_cast<const ndn::nfd::ControlParameters&>(parameters), true, done);
+    });
+
+  m_dispatcher.addStatusDataset(ndn::PartialName().append(ROUTES_DATASET),
+                                ndn::mgmt::makeAcceptAllAuthorization(),
+                                std::bind(&NdvrApiProcessor::listRoutes, this, _1, _2, _3));
+  m_dispatcher.addStatusDataset(ndn::PartialName().append(NEIGHBORS_DATASET),
+                                ndn::mgmt::makeAcceptAllAuthorization(),
+                                std::bind(&NdvrApiProcessor::listNeighbors, this, _1, _2, _3));
+  m_dispatcher.addStatusDataset(ndn::PartialName().append(DAMPING_DATASET),
+                                ndn::mgmt::makeAcceptAllAuthorization(),
+                                std::bind(&NdvrApiProcessor::listDamping, this, _1, _2, _3));
+
+  m_postRouteChange = m_dispatcher.addNotificationStream(ndn::PartialName().append(ROUTE_EVENTS_STREAM));
+}
+
+void
+NdvrApiProcessor::startListening()
+{
+  /* changes are reported against the table as it is now (including the
+   * routes restored from a snapshot) */
+  RoutingManager& routing = m_ndvr.getRoutingTable();
+  for (auto& route : routing) {
+    if (route.second.GetNextHopsSize() > 0)
+      m_publishedRoutes.emplace(route.first, std::make_pair(route.second.GetBestFaceId(),
+                                                            route.second.GetBestCost()));
+  }
+  m_routeChangeConn = routing.afterRouteChange.connect(
+    std::bind(&NdvrApiProcessor::onRouteChange, this, _1));
+
+  m_dispatcher.addTopPrefix(COMMAND_PREFIX);
+}
+
+template<typename Command>
+bool
+NdvrApiProcessor::validateParameters(const ndn::mgmt::ControlParameters& parameters)
+{
+  try {
+    Command().validateRequest(static_cast<const ndn::nfd::ControlParameters&>(parameters));
+  }
+  catch (const ndn::nfd::ControlCommand::ArgumentError&) {
+    return false;
+  }
+
+  return true;
+}
+
+ndn::mgmt::Authorization
+NdvrApiProcessor::makeCommandAuthorization()
+{
+  return [this] (const Name&, const Interest& interest, const ndn::mgmt::ControlParameters*,
+                 const ndn::mgmt::AcceptContinuation& accept,
+                 const ndn::mgmt::RejectContinuation& reject) {
+    if (!m_hasCommandRules) {
+      reject(ndn::mgmt::RejectReply::STATUS403);
+      return;
+    }
+    m_commandValidator.validate(interest,
+      [accept] (const Interest& interest) {
+        /* the requester is the signing key, as NFD reports it */
+        std::string requester;
+        try {
+          ndn::SignatureInfo sigInfo(
+            interest.getName().at(ndn::signed_interest::POS_SIG_INFO).blockFromValue());
+          if (sigInfo.hasKeyLocator() && sigInfo.getKeyLocator().getType() == tlv::Name)
+            requester = sigInfo.getKeyLocator().getName().toUri();
+        }
+        catch (const tlv::Error&) {
+        }
+        accept(requester);
+      },
+      [reject] (const Interest&, const ndn::security::v2::ValidationError&) {
+        reject(ndn::mgmt::RejectReply::STATUS403);
+      });
+  };
+}
+
+void
+NdvrApiProcessor::queueUpdate(const ndn::nfd::ControlParameters& parameters, bool withdraw,
+                              const ndn::mgmt::CommandContinuation& done)
+{
+  if (m_pendingUpdates.empty())
+    m_applyEvent = m_scheduler.schedule(time::nanoseconds::zero(),
+                                        [this] { applyUpdates(); });
+  m_pendingUpdates.push_back({parameters, {parameters.getName().toUri(), withdraw}, done});
+}
+
+void
+NdvrApiProcessor::applyUpdates()
+{
+  std::vector<PendingUpdate> pending;
+  pending.swap(m_pendingUpdates);
+
+  std::vector<NamePrefixUpdate> updates;
+  updates.reserve(pending.size());
+  for (const auto& item : pending)
+    updates.push_back(item.update);
+  std::vector<bool> applied = m_ndvr.UpdateNamePrefixes(updates);
+
+  for (size_t i = 0; i < pending.size(); ++i) {
+    /* advertising a prefix twice is not an error */
+    if (pending[i].update.withdraw && !applied[i])
+      pending[i].done(ndn::mgmt::ControlResponse(404, "Not a local prefix"));
+    else
+      pending[i].done(ndn::mgmt::ControlResponse(200, "OK")
+                        .setBody(pending[i].parameters.wireEncode()));
+  }
+}
+
+void
+NdvrApiProcessor::listRoutes(const ndn::Name& topPrefix, const ndn::Interest& interest,
+                             ndn::mgmt::StatusDatasetContext& context)
+{
+  /* routes[/<key of the last entry of the previous page>] */
+  RoutingTrie& rt = m_ndvr.getRoutingTable().m_rt;
+  auto it = rt.begin();
+  const ndn::Name& name = interest.getName();
+  size_t cursorIndex = topPrefix.size() + 1;
+  if (name.size() > cursorIndex) {
+    const auto& cursor = name[cursorIndex];
+    it = rt.upper_bound(std::string(reinterpret_cast<const char*>(cursor.value()),
+                                    cursor.value_size()));
+  }
+
+  size_t nEntries = 0;
+  std::string lastKey;
+  for (; it != rt.end() && nEntries < MAX_DATASET_ENTRIES; ++it, ++nEntries) {
+    lastKey = it->first;
+    RouteStatus status;
+    status.setPrefix(ndn::Name(it->first))
+          .setSeqNum(it->second.GetSeqNum())
+          .setOriginator(it->second.GetOriginator());
+    for (const auto& nextHop : it->second.GetNextHops()) {
+      NextHopRecord record;
+      record.faceId = nextHop.faceId;
+      record.cost = nextHop.cost;
+      record.neighbor = nextHop.neighName;
+      record.stale = m_ndvr.IsStaleNextHop(record.neighbor, it->first);
+      status.addNextHop(record);
+    }
+    context.append(status.wireEncode());
+  }
+  if (it != rt.end()) {
+    context.append(ndn::makeStringBlock(tlv::ndvr::NextPage, lastKey));
+  }
+  context.end();
+}
+
+void
+NdvrApiProcessor::listNeighbors(const ndn::Name& topPrefix, const ndn::Interest& interest,
+                                ndn::mgmt::StatusDatasetContext& context)
+{
+  for (auto& neighbor : m_ndvr.getNeighbors()) {
+    NeighborStatus status;
+    status.setName(ndn::Name(neighbor.first))
+          .setFaceId(neighbor.second.GetFaceId())
+          .setVersion(neighbor.second.GetVersion())
+          .setDvInfoVersion(neighbor.second.GetDvInfoVersion())
+          .setLastSeen(time::duration_cast<time::milliseconds>(neighbor.second.GetLastSeenDelta()));
+    context.append(status.wireEncode());
+  }
+  context.end();
+}
+
+void
+NdvrApiProcessor::listDamping(const ndn::Name& topPrefix, const ndn::Interest& interest,
+                              ndn::mgmt::StatusDatasetContext& context)
+{
+  auto list = [&context] (FlapDamping& damping, DampingKind kind) {
+    for (const auto& name : damping.getNames()) {
+      DampingStatus status;
+      status.setName(ndn::Name(name))
+            .setKind(kind)
+            .setPenalty(static_cast<uint64_t>(damping.getPenalty(name)))
+            .setReuseIn(time::duration_cast<time::milliseconds>(damping.getReuseDelay(name)));
+      context.append(status.wireEncode());
+    }
+  };
+  list(m_ndvr.getNeighborDamping(), DAMPING_NEIGHBOR);
+  list(m_ndvr.getPrefixDamping(), DAMPING_PREFIX);
+  context.end();
+}
+
+void
+NdvrApiProcessor::onRouteChange(const std::string& prefix)
+{
+  /* a zero delay event runs after the handlers already queued, so all
+   * the changes of this tick (e.g. a whole DvInfo) go in one batch */
+  if (m_changedRoutes.empty())
+    m_publishEvent = m_scheduler.schedule(time::nanoseconds::zero(),
+                                          [this] { publishRouteChanges(); });
+  m_changedRoutes.insert(prefix);
+}
+
+void
+NdvrApiProcessor::publishRouteChanges()
+{
+  RoutingManager& routing = m_ndvr.getRoutingTable();
+  RouteChangeBatch batch;
+  size_t batchSize = 0;
+
+  auto post = [&] {
+    batch.setSeqNum(++m_routeChangeSeq)
+         .setVersion(routing.GetVersion());
+    m_postRouteChange(batch.wireEncode());
+    batch = RouteChangeBatch();
+    batchSize = 0;
+  };
+
+  for (const auto& prefix : m_changedRoutes) {
+    RouteChange change;
+    auto published = m_publishedRoutes.find(prefix);
+    RoutingEntry* entry = routing.LookupRoute(prefix);
+    if (entry != nullptr && entry->GetNextHopsSize() > 0) {
+      auto best = std::make_pair(entry->GetBestFaceId(), entry->GetBestCost());
+      if (published == m_publishedRoutes.end()) {
+        change.kind = ROUTE_ADDED;
+        m_publishedRoutes.emplace(prefix, best);
+      }
+      else if (published->second != best) {
+        change.kind = ROUTE_BEST_CHANGED;
+        published->second = best;
+      }
+      else {
+        /* only the seqNum or a backup next hop changed */
+        continue;
+      }
+      change.faceId = best.first;
+      change.cost = best.second;
+    }
+    else {
+      if (published == m_publishedRoutes.end())
+        continue;
+      change.kind = ROUTE_REMOVED;
+      m_publishedRoutes.erase(published);
+    }
+    change.prefix = ndn::Name(prefix);
+
+    /* Name plus ChangeKind, FaceId and Cost */
+    size_t changeSize = change.prefix.wireEncode().size() + 32;
+    if (batchSize > 0 && batchSize + changeSize > MAX_NOTIFICATION_SIZE)
+      post();
+    batch.addChange(change);
+    batchSize += changeSize;
+  }
+  m_changedRoutes.clear();
+
+  if (batchSize > 0)
+    post();
+}
+
+} // namespace ndvr
+} // namespace ndn
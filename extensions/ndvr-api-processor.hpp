@@ -0,0 +1,149 @@
+#ifndef NDVR_API_PROCESSOR_HPP
+#define NDVR_API_PROCESSOR_HPP
+
+#include "ndvr-api-commands.hpp"
+#include "ndvr.hpp"
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/interest.hpp>
+#include <ndn-cxx/mgmt/dispatcher.hpp>
+#include <ndn-cxx/mgmt/nfd/control-parameters.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/validator-config.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+#include <ndn-cxx/util/signal.hpp>
+
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <set>
+
+namespace ndn {
+
+namespace ndvr {
+
+/** @brief Management API of a running router, under /localhost/ndvr
+ *
+ * Control commands (signed command Interests, see ndvr-api-commands.hpp):
+ *  - advertise: start announcing a local name prefix
+ *  - withdraw: stop announcing a local name prefix
+ *  The commands received in the same event-loop tick are applied together
+ *  (Ndvr::UpdateNamePrefixes), so a producer registering many prefixes at
+ *  once causes one routing update rather than one per prefix.
+ *
+ * Status datasets (RouteStatus and NeighborStatus, see ndvr-status.hpp):
+ *  - routes: the routing table, in name component order. At most
+ *    MAX_DATASET_ENTRIES entries per request, so a large table neither
+ *    stalls the event loop nor fills the in-memory storage; when there
+ *    are more, the dataset ends with a NextPage element and the
+ *    following page is fetched from routes/<NextPage value>
+ *  - neighbors: the neighbor table
+ *  - damping: DampingStatus of the flapping prefixes and neighbors
+ *
+ * Notification stream:
+ *  - route-events: RouteChangeBatch notifications (added, removed, best
+ *    next hop changed). Changes are collected from RoutingManager and
+ *    published once per event-loop tick, so a DvInfo touching many
+ *    prefixes yields one batch (or a few, when they do not fit in one
+ *    packet). Batches are numbered; on a gap, refetch routes.
+ *
+ * /localhost is only reachable from local applications (NFD scope
+ * control), so the datasets and the notification stream are open to
+ * all of them. The control commands change what every neighbor learns:
+ * they are authorized only when the command Interest validates against
+ * commandValidationConfig (ValidatorConfig rules, e.g. the operators'
+ * certificates as trust anchors, see config/api-validation.conf), which
+ * also rejects replayed or stale command Interests. Without rules, every
+ * command is rejected.
+ */
+class NdvrApiProcessor : boost::noncopyable
+{
+public:
+  NdvrApiProcessor(Ndvr& ndvr,
+                   ndn::Face& face,
+                   ndn::KeyChain& keyChain,
+                   const std::string& commandValidationConfig);
+
+  void
+  startListening();
+
+private:
+  void
+  queueUpdate(const ndn::nfd::ControlParameters& parameters, bool withdraw,
+               const ndn::mgmt::CommandContinuation& done);
+
+  void
+  applyUpdates();
+
+  void
+  listRoutes(const ndn::Name& topPrefix, const ndn::Interest& interest,
+             ndn::mgmt::StatusDatasetContext& context);
+
+  void
+  listNeighbors(const ndn::Name& topPrefix, const ndn::Interest& interest,
+                ndn::mgmt::StatusDatasetContext& context);
+
+  void
+  listDamping(const ndn::Name& topPrefix, const ndn::Interest& interest,
+              ndn::mgmt::StatusDatasetContext& context);
+
+  template<typename Command>
+  static bool
+  validateParameters(const ndn::mgmt::ControlParameters& parameters);
+
+  /** @brief accepts signed command Interests that m_commandValidator validates */
+  ndn::mgmt::Authorization
+  makeCommandAuthorization();
+
+  void
+  onRouteChange(const std::string& prefix);
+
+  void
+  publishRouteChanges();
+
+public:
+  static const ndn::Name COMMAND_PREFIX; // /localhost/ndvr
+  static const size_t MAX_DATASET_ENTRIES;
+  /* encoded size of the changes of one notification, leaving room for its
+   * name and signature in a packet */
+  static const size_t MAX_NOTIFICATION_SIZE;
+
+private:
+  Ndvr& m_ndvr;
+  ndn::mgmt::Dispatcher m_dispatcher;
+  ndn::Scheduler m_scheduler;
+  /* advertise/withdraw: local keys only, certificates are not fetched */
+  ndn::security::ValidatorConfig m_commandValidator;
+  bool m_hasCommandRules = false;
+
+  /* advertise/withdraw commands of this tick */
+  struct PendingUpdate
+  {
+    ndn::nfd::ControlParameters parameters;
+    NamePrefixUpdate update;
+    ndn::mgmt::CommandContinuation done;
+  };
+  std::vector<PendingUpdate> m_pendingUpdates;
+  ndn::scheduler::ScopedEventId m_applyEvent;
+
+  /* route-events */
+  ndn::mgmt::PostNotification m_postRouteChange;
+  ndn::util::signal::ScopedConnection m_routeChangeConn;
+  ndn::scheduler::ScopedEventId m_publishEvent;
+  std::set<std::string> m_changedRoutes;
+  /* best <faceId, cost> subscribers were told about, per prefix */
+  std::map<std::string, std::pair<uint64_t, uint32_t>> m_publishedRoutes;
+  uint64_t m_routeChangeSeq = 0;
+
+  static const ndn::Name::Component ADVERTISE_VERB;
+  static const ndn::Name::Component WITHDRAW_VERB;
+  static const ndn::Name::Component ROUTES_DATASET;
+  static const ndn::Name::Component NEIGHBORS_DATASET;
+  static const ndn::Name::Component DAMPING_DATASET;
+  static const ndn::Name::Component ROUTE_EVENTS_STREAM;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_API_PROCESSOR_HPP
@@ -36,7 +36,18 @@ public:
       .AddAttribute("SyncDataRounds", "Deprecated: Number of rounds to run the sync data process", IntegerValue(0),
                     MakeIntegerAccessor(&NdvrApp::syncDataRounds_), MakeIntegerChecker<int32_t>())
       .AddAttribute("EnableUnicastFace", "Enable dynamic creating unicast faces", BooleanValue(false),
-                    MakeBooleanAccessor(&NdvrApp::unicastFaces_), MakeBooleanChecker());
+                    MakeBooleanAccessor(&NdvrApp::unicastFaces_), MakeBooleanChecker())
+      .AddAttribute("SigningMode", "DvInfo signing scheme: ecdsa or hmac", StringValue("ecdsa"),
+                    MakeStringAccessor(&NdvrApp::signingMode_), MakeStringChecker())
+      .AddAttribute("HmacKeyFile", "File with the network secret used when SigningMode is hmac", StringValue(""),
+                    MakeStringAccessor(&NdvrApp::hmacKeyFile_), MakeStringChecker())
+      .AddAttribute("HmacRotation", "HMAC key rotation interval (seconds)", IntegerValue(3600),
+                    MakeIntegerAccessor(&NdvrApp::hmacRotation_), MakeIntegerChecker<int32_t>(1))
+      .AddAttribute("AggregatePrefixes", "Announce the parent of this many local prefixes instead of them (0: disabled)",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&NdvrApp::aggregatePrefixes_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("FlapDamping", "Damp flapping neighbors and prefixes", BooleanValue(true),
+                    MakeBooleanAccessor(&NdvrApp::flapDamping_), MakeBooleanChecker());
     return tid;
   }
 
@@ -50,6 +61,16 @@ public:
     m_instance->AdvNamePrefix(name);
   }
 
+  /* Withdraw a name prefix advertised before */
+  bool WithdrawNamePrefix(std::string& name) {
+    return m_instance->WithdrawNamePrefix(name);
+  }
+
+  /* Advertise and withdraw many name prefixes as one routing update */
+  std::vector<bool> UpdateNamePrefixes(const std::vector<::ndn::ndvr::NamePrefixUpdate>& updates) {
+    return m_instance->UpdateNamePrefixes(updates);
+  }
+
   void AddSigningInfo(::ndn::security::SigningInfo signingInfo) {
     signingInfo_ = signingInfo;
   }
@@ -71,17 +92,29 @@ public:
 protected:
   virtual void StartApplication() {
     getFacesFromNetdev();
-    m_instance.reset(new ::ndn::ndvr::Ndvr(signingInfo_, network_, routerName_, namePrefixes_, faces_, validationConfig_));
+    m_face.reset(new ::ndn::Face());
+    m_instance.reset(new ::ndn::ndvr::Ndvr(*m_face, m_keyChain, signingInfo_, network_, routerName_, namePrefixes_, faces_, monitorFaces_, validationConfig_));
     m_instance->EnableUnicastFaces(unicastFaces_);
+    m_instance->SetDvInfoSigner(::ndn::ndvr::makeDvInfoSigner(signingMode_, m_keyChain, signingInfo_, network_,
+                                                              hmacKeyFile_, ::ndn::time::seconds(hmacRotation_)));
+    m_instance->SetPrefixAggregation(aggregatePrefixes_);
+    if (!flapDamping_) {
+      ::ndn::ndvr::FlapDamping::Params noDamping;
+      noDamping.flapPenalty = 0;
+      m_instance->SetFlapDamping(noDamping);
+    }
     m_instance->Start();
   }
 
   virtual void StopApplication() {
     m_instance->Stop();
     m_instance.reset();
+    m_face.reset();
   }
 
 private:
+  std::unique_ptr<::ndn::Face> m_face;
+  ::ndn::KeyChain m_keyChain;
   std::unique_ptr<::ndn::ndvr::Ndvr> m_instance;
   ::ndn::security::SigningInfo signingInfo_;
   ndn::Name network_;
@@ -90,7 +123,13 @@ private:
   uint32_t syncDataRounds_;      // number of rounds to sync data (for data sync experiment)
   bool unicastFaces_;
   std::string validationConfig_;
+  std::string signingMode_;
+  std::string hmacKeyFile_;
+  int32_t hmacRotation_;
+  uint32_t aggregatePrefixes_;
+  bool flapDamping_;
   std::vector<std::string> faces_;
+  std::vector<std::string> monitorFaces_;
 };
 
 } // namespace ns3
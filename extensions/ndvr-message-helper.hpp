@@ -33,10 +33,6 @@ inline RoutingTable DecodeDvInfo(const proto::DvInfo &dvinfo_proto) {
     auto cost = entry.cost();
     // auto bestnexthop = entry.bestnexthop();
     // auto sec_cost = entry.sec_cost();
-    std::cout << "###### DecodeDvInfo ######" << std::endl;
-    std::cout << "  prefix = " << prefix << ", seq = " << seq
-              << ", originator = " << originator << ", cost = " << cost
-              << std::endl;
 
     // TODO add multiple nexthops
     std::vector<std::string> ids;
@@ -45,8 +41,6 @@ inline RoutingTable DecodeDvInfo(const proto::DvInfo &dvinfo_proto) {
       ids.push_back(entry.next_hops().router_id(j));
     }
 
-    std::cout << "  next hops = " << join(ids, ",") << std::endl;
-    // std::cout << "### >> prefix     :" << routerPrefix_Uri << std::endl;
 
     NextHop nextHop = NextHop(ids);
 
@@ -55,9 +49,11 @@ inline RoutingTable DecodeDvInfo(const proto::DvInfo &dvinfo_proto) {
       prefixPathVector[prefix] = PathVectors();
     }
     auto &pathVectors = prefixPathVector[prefix];
-    pathVectors.addPath(0, nextHop); // faceID = 0 is incorrect, but we will fix
-                                     // it later in the processingDvInfo code
-    std::cout << "  pathvector = " << pathVectors << std::endl;
+    /* a withdrawn prefix has no path: its cost stays infinite */
+    if (cost != std::numeric_limits<uint32_t>::max())
+      pathVectors.addPath(0, nextHop); // faceID = 0 is incorrect, but we will
+                                       // fix it later in the processingDvInfo
+                                       // code
 
     RoutingEntry re = RoutingEntry(prefix, seq, originator, cost, pathVectors);
 
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndvr-multi-runner.hpp"
+
+#include <ndn-cxx/transport/unix-transport.hpp>
+
+#include <boost/property_tree/info_parser.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+NdvrMultiRunner::NdvrMultiRunner(const std::string& configFile)
+  : m_signals(m_io, SIGINT, SIGTERM)
+  , m_retainedCerts(std::make_shared<RetainedCertificates>())
+{
+  boost::property_tree::ptree config;
+  try {
+    boost::property_tree::read_info(configFile, config);
+  }
+  catch (const boost::property_tree::info_parser_error& e) {
+    throw Error("Failed to parse " + configFile + ": " + e.what());
+  }
+
+  const auto& general = config.get_child("general", boost::property_tree::ptree());
+  std::string network = general.get<std::string>("network", "/ndn");
+  std::string validationConfig = general.get<std::string>("validation-config", "");
+  int helloInterval = general.get<int>("hello-interval", 0);
+  int cryptoWorkers = general.get<int>("workers", 0);
+  std::string signingMode = general.get<std::string>("signing", "ecdsa");
+  std::string hmacKeyFile = general.get<std::string>("hmac-key-file", "");
+  int hmacRotation = general.get<int>("hmac-rotation", 3600);
+  std::string apiValidationConfig = general.get<std::string>("api-validation-config", "");
+  if (validationConfig.empty())
+    throw Error("Missing general.validation-config in " + configFile);
+
+  if (cryptoWorkers > 0)
+    m_cryptoPool.reset(new CryptoWorkerPool(cryptoWorkers));
+
+  for (const auto& item : config) {
+    if (item.first == "general")
+      continue;
+    if (item.first != "router")
+      throw Error("Unknown section '" + item.first + "' in " + configFile);
+
+    const auto& section = item.second;
+    std::unique_ptr<Router> router(new Router);
+    router->name = section.get<std::string>("name", "");
+    if (router->name.empty())
+      throw Error("Missing router.name in " + configFile);
+
+    std::vector<std::string> namePrefixes;
+    std::vector<std::string> faces;
+    std::vector<std::string> monitorFaces;
+    for (const auto& param : section) {
+      if (param.first == "prefix")
+        namePrefixes.push_back(param.second.get_value<std::string>());
+      else if (param.first == "face")
+        faces.push_back(param.second.get_value<std::string>());
+      else if (param.first == "monitor-face")
+        monitorFaces.push_back(param.second.get_value<std::string>());
+    }
+    if (faces.empty())
+      throw Error("Router " + router->name + " must have at least one face");
+
+    std::string pib = section.get<std::string>("pib", "");
+    std::string tpm = section.get<std::string>("tpm", "");
+    if (pib.empty() && tpm.empty()) {
+      router->keyChain.reset(new KeyChain());
+      if (m_cryptoPool)
+        router->signingKeyChain.reset(new KeyChain());
+    }
+    else {
+      router->keyChain.reset(new KeyChain(pib, tpm));
+      if (m_cryptoPool)
+        router->signingKeyChain.reset(new KeyChain(pib, tpm));
+    }
+
+    std::string nfdSocket = section.get<std::string>("nfd-socket", "");
+    shared_ptr<Transport> transport;
+    if (!nfdSocket.empty())
+      transport = make_shared<UnixTransport>(nfdSocket);
+    router->face.reset(new Face(transport, m_io, *router->keyChain));
+
+    router->signingInfo = security::SigningInfo(security::SigningInfo::SIGNER_TYPE_ID,
+                                                network + router->name);
+    router->ndvr.reset(new Ndvr(*router->face, *router->keyChain, router->signingInfo, network,
+                                router->name, namePrefixes, faces, monitorFaces, validationConfig));
+    if (helloInterval != 0)
+      router->ndvr->SetHelloInterval(helloInterval);
+    router->ndvr->SetRetainedCertificates(m_retainedCerts);
+    router->ndvr->SetCryptoWorkerPool(m_cryptoPool.get());
+    router->ndvr->SetDvInfoSigner(makeDvInfoSigner(signingMode,
+                                                   m_cryptoPool ? *router->signingKeyChain : *router->keyChain,
+                                                   router->signingInfo, network, hmacKeyFile,
+                                                   time::seconds(hmacRotation)));
+    std::string snapshotFile = section.get<std::string>("snapshot", "");
+    if (!snapshotFile.empty())
+      router->ndvr->SetSnapshotFile(snapshotFile);
+    int aggregatePrefixes = section.get<int>("aggregate", 0);
+    if (aggregatePrefixes > 0)
+      router->ndvr->SetPrefixAggregation(aggregatePrefixes);
+    router->api.reset(new NdvrApiProcessor(*router->ndvr, *router->face, *router->keyChain,
+                                           apiValidationConfig));
+    m_routers.push_back(std::move(router));
+  }
+
+  if (m_routers.empty())
+    throw Error("No router section in " + configFile);
+}
+
+NdvrMultiRunner::~NdvrMultiRunner()
+{
+  /* in-flight jobs use the routers' signers and key chains */
+  m_cryptoPool.reset();
+  m_routers.clear();
+}
+
+void
+NdvrMultiRunner::run()
+{
+  for (auto& router : m_routers) {
+    router->ndvr->Start();
+    router->api->startListening();
+  }
+  m_signals.async_wait([this] (const boost::system::error_code& error, int) {
+      if (error)
+        return;
+      for (auto& router : m_routers) {
+        router->ndvr->Stop();
+      }
+      m_io.stop();
+    });
+
+  try {
+    m_io.run();
+  }
+  catch (std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+
+    for (auto& router : m_routers) {
+      router->ndvr->cleanup();
+    }
+  }
+}
+
+} // namespace ndvr
+} // namespace ndn
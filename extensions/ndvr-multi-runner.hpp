@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_MULTI_RUNNER_HPP
+#define NDVR_MULTI_RUNNER_HPP
+
+#include "ndvr.hpp"
+#include "ndvr-api-processor.hpp"
+
+#include <ndn-cxx/face.hpp>
+
+// boost needs to be included after ndn-cxx, otherwise there will be conflict with _1, _2, ...
+#include <boost/asio.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/** @brief Hosts many Ndvr instances (routers) in one process
+ *
+ * Every router keeps its own Face (to its node's NFD), KeyChain and
+ * Ndvr, but all of them share:
+ *  - one io_service (single event-loop thread)
+ *  - one CryptoWorkerPool for signing, verification and decoding
+ *  - the neighbors' certificates retained once validated (see
+ *    RetainingCertificateFetcher)
+ *  - the parsed validation rules (see getParsedValidationConfig)
+ *
+ * Configuration file (INFO format, like validation.conf):
+ *
+ *    general
+ *    {
+ *      network /ndn
+ *      validation-config /usr/local/etc/ndn/ndvr-validation.conf
+ *      hello-interval 1        ; optional
+ *      workers 8               ; optional, default 0 (event loop)
+ *      signing ecdsa           ; optional, ecdsa or hmac
+ *      hmac-key-file net.key   ; for signing hmac
+ *      hmac-rotation 3600      ; optional
+ *      api-validation-config api-validation.conf ; optional, see NdvrApiProcessor
+ *    }
+ *    router
+ *    {
+ *      name /%C1.Router/a
+ *      nfd-socket /run/a.sock  ; optional, default from client.conf
+ *      pib pib-sqlite3:/tmp/minindn/a/.ndn            ; optional
+ *      tpm tpm-file:/tmp/minindn/a/.ndn/ndnsec-key-file ; optional
+ *      prefix /ndn/a-site      ; repeatable
+ *      face 260                ; repeatable, at least one
+ *      monitor-face ether://[01:00:5e:00:17:aa]      ; repeatable
+ *      snapshot /var/lib/ndvr/a.snapshot  ; optional, see Ndvr::SetSnapshotFile
+ *      aggregate 2             ; optional, see Ndvr::SetPrefixAggregation
+ *    }
+ *    router
+ *    {
+ *      ...
+ *    }
+ */
+class NdvrMultiRunner
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  explicit
+  NdvrMultiRunner(const std::string& configFile);
+
+  ~NdvrMultiRunner();
+
+  void
+  run();
+
+  size_t
+  getNRouters() const
+  {
+    return m_routers.size();
+  }
+
+private:
+  struct Router
+  {
+    std::string name;
+    std::unique_ptr<KeyChain> keyChain;
+    /* used only by the crypto workers: KeyChain is not thread-safe */
+    std::unique_ptr<KeyChain> signingKeyChain;
+    std::unique_ptr<Face> face;
+    security::SigningInfo signingInfo;
+    std::unique_ptr<Ndvr> ndvr;
+    /* /localhost/ndvr on the router's own NFD */
+    std::unique_ptr<NdvrApiProcessor> api;
+  };
+
+private:
+  boost::asio::io_service m_io;
+  boost::asio::signal_set m_signals;
+  std::unique_ptr<CryptoWorkerPool> m_cryptoPool;
+  std::shared_ptr<RetainedCertificates> m_retainedCerts;
+  /* unique_ptr: Ndvr keeps references to signingInfo */
+  std::vector<std::unique_ptr<Router>> m_routers;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_MULTI_RUNNER_HPP
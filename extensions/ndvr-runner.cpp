@@ -6,19 +6,38 @@
 namespace ndn {
 namespace ndvr {
 
-NdvrRunner::NdvrRunner(std::string& networkName, std::string& routerName, int helloInterval, std::string& validationConfig, std::vector<std::string>& namePrefixes, std::vector<std::string>& faces, std::vector<std::string>& monitorFaces)
+NdvrRunner::NdvrRunner(std::string& networkName, std::string& routerName, int helloInterval, std::string& validationConfig, std::vector<std::string>& namePrefixes, std::vector<std::string>& faces, std::vector<std::string>& monitorFaces, const std::string& signingMode, const std::string& hmacKeyFile, int hmacRotation, int cryptoWorkers, const std::string& snapshotFile, int aggregatePrefixes, const std::string& apiValidationConfig)
+  : m_signals(m_face.getIoService(), SIGINT, SIGTERM)
 {
   m_signingInfo = ndn::security::SigningInfo(ndn::security::SigningInfo::SIGNER_TYPE_ID,
                                              networkName + routerName);
-  m_ndvr = std::make_shared<Ndvr>(m_signingInfo, networkName, routerName, namePrefixes, faces, monitorFaces, validationConfig);
+  m_ndvr = std::make_shared<Ndvr>(m_face, m_keyChain, m_signingInfo, networkName, routerName, namePrefixes, faces, monitorFaces, validationConfig);
   if (helloInterval != 0)
     m_ndvr->SetHelloInterval(helloInterval);
+  if (cryptoWorkers > 0) {
+    m_cryptoPool.reset(new CryptoWorkerPool(cryptoWorkers));
+    m_ndvr->SetCryptoWorkerPool(m_cryptoPool.get());
+  }
+  m_ndvr->SetDvInfoSigner(makeDvInfoSigner(signingMode, m_cryptoPool ? m_signingKeyChain : m_keyChain,
+                                           m_signingInfo, networkName, hmacKeyFile, time::seconds(hmacRotation)));
+  if (!snapshotFile.empty())
+    m_ndvr->SetSnapshotFile(snapshotFile);
+  if (aggregatePrefixes > 0)
+    m_ndvr->SetPrefixAggregation(aggregatePrefixes);
+  m_api.reset(new NdvrApiProcessor(*m_ndvr, m_face, m_keyChain, apiValidationConfig));
 }
 
 void
 NdvrRunner::run()
 {
   m_ndvr->Start();
+  m_api->startListening();
+  m_signals.async_wait([this] (const boost::system::error_code& error, int) {
+      if (error)
+        return;
+      m_ndvr->Stop();
+      m_face.getIoService().stop();
+    });
   try {
     m_ndvr->run();
   }
@@ -40,6 +59,14 @@ NdvrRunner::printUsage(const std::string& programName)
   std::cout << "       -p <NAME>   Specify the name prefix to be announced (can be used multiple times)" << std::endl;
   std::cout << "       -f <FACE>   Specify the face ID in which NDVR will work (can be used multiple times)" << std::endl;
   std::cout << "       -m <FACE>   Specify the face URI (remoteUri) in which NDVR will monitor for nfd/faces/events (can be used multiple times)" << std::endl;
+  std::cout << "       -s <MODE>   DvInfo signing scheme: ecdsa (default, router's key) or hmac (network shared key)" << std::endl;
+  std::cout << "       -k <FILE>   File with the network secret for -s hmac (same on every router)" << std::endl;
+  std::cout << "       -K <SEC>    HMAC key rotation interval (default: 3600)" << std::endl;
+  std::cout << "       -w <NUM>    Worker threads for DvInfo signing, verification and decoding (default: 0, runs them in the event loop)" << std::endl;
+  std::cout << "       -S <FILE>   Save the routing state to FILE and restore it when restarting" << std::endl;
+  std::cout << "       -a <NUM>    Announce the parent of NUM or more local prefixes instead of them (default: 0, disabled)" << std::endl;
+  std::cout << "       -A <FILE>   Validation rules of the advertise/withdraw management commands (default: none, commands rejected)" << std::endl;
+  std::cout << "       -c <FILE>   Run many routers in this process, configured from FILE (the options above are ignored)" << std::endl;
   std::cout << "       -h          Display usage " << std::endl;
   std::cout << "" << std::endl;
   std::cout << "SECURITY IDENTITY" << std::endl;
@@ -58,6 +85,12 @@ NdvrRunner::printUsage(const std::string& programName)
   std::cout << "   by providing the faceId (face already created) or face Uri (to be" << std::endl;
   std::cout << "   created by NDVR). Examplei (more in nfd wiki FaceMgmt):" << std::endl;
   std::cout << "      -f ether://[08:00:27:01:01:01] -f dev://wlan0 ..." << std::endl;
+  std::cout << "" << std::endl;
+  std::cout << "HMAC SIGNING" << std::endl;
+  std::cout << "   With -s hmac, DvInfo is signed with HMAC-SHA256 using a key derived" << std::endl;
+  std::cout << "   from the network secret and rotated every -K seconds. Any holder of" << std::endl;
+  std::cout << "   the secret can sign, so only use it in closed networks. To create it:" << std::endl;
+  std::cout << "      head -c 32 /dev/urandom > ndvr-network.key" << std::endl;
 }
 
 } // namespace ndvr
@@ -4,6 +4,7 @@
 #define NDVR_RUNNER_HPP
 
 #include "ndvr.hpp"
+#include "ndvr-api-processor.hpp"
 
 #include <ndn-cxx/face.hpp>
 #include <ndn-cxx/util/scheduler.hpp>
@@ -27,7 +28,7 @@ public:
     }
   };
 
-  NdvrRunner(std::string& networkName, std::string& routerName, int helloInterval, std::string& validationConfig, std::vector<std::string>& namePrefixes, std::vector<std::string>& faces, std::vector<std::string>& monitorFaces);
+  NdvrRunner(std::string& networkName, std::string& routerName, int helloInterval, std::string& validationConfig, std::vector<std::string>& namePrefixes, std::vector<std::string>& faces, std::vector<std::string>& monitorFaces, const std::string& signingMode, const std::string& hmacKeyFile, int hmacRotation, int cryptoWorkers, const std::string& snapshotFile, int aggregatePrefixes, const std::string& apiValidationConfig);
 
   void
   run();
@@ -36,8 +37,18 @@ public:
   printUsage(const std::string& programName);
 
 private:
+  ndn::Face m_face;
+  ndn::KeyChain m_keyChain;
+  /* used only by the crypto workers: KeyChain is not thread-safe */
+  ndn::KeyChain m_signingKeyChain;
   std::shared_ptr<Ndvr> m_ndvr;
   ndn::security::SigningInfo m_signingInfo;
+  /* SIGINT/SIGTERM: stop cleanly, saving the routing snapshot */
+  boost::asio::signal_set m_signals;
+  /* /localhost/ndvr management API */
+  std::unique_ptr<NdvrApiProcessor> m_api;
+  /* destroyed first, so no job outlives what it uses */
+  std::unique_ptr<CryptoWorkerPool> m_cryptoPool;
 };
 
 } // namespace ndvr
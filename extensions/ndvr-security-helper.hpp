@@ -34,9 +34,8 @@ setupRootCert(const ndn::Name& subjectName) {
 }
 
 inline ndn::security::SigningInfo
-setupSigningInfo(const ndn::Name subjectName, const ndn::Name issuerName) {
+setupSigningInfo(ndn::KeyChain& keyChain, const ndn::Name subjectName, const ndn::Name issuerName) {
   // 1. Create identity/key/certificate (unsigned certificate)
-  ndn::KeyChain keyChain;
   try {
     /* cleanup: remove any possible existing certificate with the same name */
     keyChain.deleteIdentity(keyChain.getPib().getIdentity(subjectName));
@@ -69,6 +68,12 @@ setupSigningInfo(const ndn::Name subjectName, const ndn::Name issuerName) {
   return ndn::security::SigningInfo(ndn::security::SigningInfo::SIGNER_TYPE_ID, subjectName);
 }
 
+inline ndn::security::SigningInfo
+setupSigningInfo(const ndn::Name subjectName, const ndn::Name issuerName) {
+  ndn::KeyChain keyChain;
+  return setupSigningInfo(keyChain, subjectName, issuerName);
+}
+
 }  // namespace ndvr
 }  // namespace ndn
 
@@ -0,0 +1,609 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndvr-status.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/tlv-nfd.hpp>
+#include <ndn-cxx/util/concepts.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+template<encoding::Tag TAG>
+static size_t
+encodeNextHop(EncodingImpl<TAG>& encoder, const NextHopRecord& nextHop)
+{
+  size_t totalLength = 0;
+
+  if (nextHop.stale) {
+    totalLength += prependEmptyBlock(encoder, tlv::ndvr::Stale);
+  }
+  totalLength += prependStringBlock(encoder, tlv::ndvr::Neighbor, nextHop.neighbor);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::nfd::Cost, nextHop.cost);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::nfd::FaceId, nextHop.faceId);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::ndvr::NextHopRecord);
+  return totalLength;
+}
+
+static NextHopRecord
+decodeNextHop(const Block& wire)
+{
+  if (wire.type() != tlv::ndvr::NextHopRecord) {
+    NDN_THROW(RouteStatus::Error("NextHopRecord", wire.type()));
+  }
+  wire.parse();
+
+  NextHopRecord nextHop;
+  bool hasFaceId = false;
+  bool hasCost = false;
+  for (const auto& element : wire.elements()) {
+    switch (element.type()) {
+      case tlv::nfd::FaceId:
+        nextHop.faceId = readNonNegativeInteger(element);
+        hasFaceId = true;
+        break;
+      case tlv::nfd::Cost:
+        nextHop.cost = readNonNegativeIntegerAs<uint32_t>(element);
+        hasCost = true;
+        break;
+      case tlv::ndvr::Neighbor:
+        nextHop.neighbor = readString(element);
+        break;
+      case tlv::ndvr::Stale:
+        nextHop.stale = true;
+        break;
+      default:
+        /* ignore unknown fields, for newer routers */
+        break;
+    }
+  }
+  if (!hasFaceId || !hasCost) {
+    NDN_THROW(RouteStatus::Error("Missing FaceId or Cost in NextHopRecord"));
+  }
+  return nextHop;
+}
+
+RouteStatus&
+RouteStatus::setPrefix(const Name& prefix)
+{
+  m_wire.reset();
+  m_prefix = prefix;
+  return *this;
+}
+
+RouteStatus&
+RouteStatus::setSeqNum(uint64_t seqNum)
+{
+  m_wire.reset();
+  m_seqNum = seqNum;
+  return *this;
+}
+
+RouteStatus&
+RouteStatus::setOriginator(const std::string& originator)
+{
+  m_wire.reset();
+  m_originator = originator;
+  return *this;
+}
+
+RouteStatus&
+RouteStatus::addNextHop(const NextHopRecord& nextHop)
+{
+  m_wire.reset();
+  m_nextHops.push_back(nextHop);
+  return *this;
+}
+
+template<encoding::Tag TAG>
+size_t
+RouteStatus::wireEncode(EncodingImpl<TAG>& encoder) const
+{
+  size_t totalLength = 0;
+
+  for (auto it = m_nextHops.rbegin(); it != m_nextHops.rend(); ++it) {
+    totalLength += encodeNextHop(encoder, *it);
+  }
+  totalLength += prependStringBlock(encoder, tlv::ndvr::Originator, m_originator);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::SeqNum, m_seqNum);
+  totalLength += m_prefix.wireEncode(encoder);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::ndvr::RouteStatus);
+  return totalLength;
+}
+
+NDN_CXX_DEFINE_WIRE_ENCODE_INSTANTIATIONS(RouteStatus);
+
+const Block&
+RouteStatus::wireEncode() const
+{
+  if (m_wire.hasWire())
+    return m_wire;
+
+  EncodingEstimator estimator;
+  size_t estimatedSize = wireEncode(estimator);
+
+  EncodingBuffer buffer(estimatedSize, 0);
+  wireEncode(buffer);
+
+  m_wire = buffer.block();
+  return m_wire;
+}
+
+void
+RouteStatus::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::ndvr::RouteStatus) {
+    NDN_THROW(Error("RouteStatus", wire.type()));
+  }
+  m_wire = wire;
+  m_wire.parse();
+
+  m_prefix.clear();
+  m_seqNum = 0;
+  m_originator.clear();
+  m_nextHops.clear();
+
+  auto val = m_wire.elements_begin();
+  if (val == m_wire.elements_end() || val->type() != tlv::Name) {
+    NDN_THROW(Error("Missing Name in RouteStatus"));
+  }
+  m_prefix.wireDecode(*val);
+  for (++val; val != m_wire.elements_end(); ++val) {
+    switch (val->type()) {
+      case tlv::ndvr::SeqNum:
+        m_seqNum = readNonNegativeInteger(*val);
+        break;
+      case tlv::ndvr::Originator:
+        m_originator = readString(*val);
+        break;
+      case tlv::ndvr::NextHopRecord:
+        m_nextHops.push_back(decodeNextHop(*val));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+NeighborStatus&
+NeighborStatus::setName(const Name& name)
+{
+  m_wire.reset();
+  m_name = name;
+  return *this;
+}
+
+NeighborStatus&
+NeighborStatus::setFaceId(uint64_t faceId)
+{
+  m_wire.reset();
+  m_faceId = faceId;
+  return *this;
+}
+
+NeighborStatus&
+NeighborStatus::setVersion(uint64_t version)
+{
+  m_wire.reset();
+  m_version = version;
+  return *this;
+}
+
+NeighborStatus&
+NeighborStatus::setDvInfoVersion(uint64_t version)
+{
+  m_wire.reset();
+  m_dvInfoVersion = version;
+  return *this;
+}
+
+NeighborStatus&
+NeighborStatus::setLastSeen(time::milliseconds lastSeen)
+{
+  m_wire.reset();
+  m_lastSeen = lastSeen;
+  return *this;
+}
+
+template<encoding::Tag TAG>
+size_t
+NeighborStatus::wireEncode(EncodingImpl<TAG>& encoder) const
+{
+  size_t totalLength = 0;
+
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::LastSeen,
+                                                static_cast<uint64_t>(m_lastSeen.count()));
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::DvInfoVersion, m_dvInfoVersion);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::Version, m_version);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::nfd::FaceId, m_faceId);
+  totalLength += m_name.wireEncode(encoder);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::ndvr::NeighborStatus);
+  return totalLength;
+}
+
+NDN_CXX_DEFINE_WIRE_ENCODE_INSTANTIATIONS(NeighborStatus);
+
+const Block&
+NeighborStatus::wireEncode() const
+{
+  if (m_wire.hasWire())
+    return m_wire;
+
+  EncodingEstimator estimator;
+  size_t estimatedSize = wireEncode(estimator);
+
+  EncodingBuffer buffer(estimatedSize, 0);
+  wireEncode(buffer);
+
+  m_wire = buffer.block();
+  return m_wire;
+}
+
+void
+NeighborStatus::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::ndvr::NeighborStatus) {
+    NDN_THROW(Error("NeighborStatus", wire.type()));
+  }
+  m_wire = wire;
+  m_wire.parse();
+
+  m_name.clear();
+  m_faceId = m_version = m_dvInfoVersion = 0;
+  m_lastSeen = time::milliseconds::zero();
+
+  auto val = m_wire.elements_begin();
+  if (val == m_wire.elements_end() || val->type() != tlv::Name) {
+    NDN_THROW(Error("Missing Name in NeighborStatus"));
+  }
+  m_name.wireDecode(*val);
+  for (++val; val != m_wire.elements_end(); ++val) {
+    switch (val->type()) {
+      case tlv::nfd::FaceId:
+        m_faceId = readNonNegativeInteger(*val);
+        break;
+      case tlv::ndvr::Version:
+        m_version = readNonNegativeInteger(*val);
+        break;
+      case tlv::ndvr::DvInfoVersion:
+        m_dvInfoVersion = readNonNegativeInteger(*val);
+        break;
+      case tlv::ndvr::LastSeen:
+        m_lastSeen = time::milliseconds(readNonNegativeInteger(*val));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+DampingStatus&
+DampingStatus::setName(const Name& name)
+{
+  m_wire.reset();
+  m_name = name;
+  return *this;
+}
+
+DampingStatus&
+DampingStatus::setKind(DampingKind kind)
+{
+  m_wire.reset();
+  m_kind = kind;
+  return *this;
+}
+
+DampingStatus&
+DampingStatus::setPenalty(uint64_t penalty)
+{
+  m_wire.reset();
+  m_penalty = penalty;
+  return *this;
+}
+
+DampingStatus&
+DampingStatus::setReuseIn(time::milliseconds reuseIn)
+{
+  m_wire.reset();
+  m_reuseIn = reuseIn;
+  return *this;
+}
+
+template<encoding::Tag TAG>
+size_t
+DampingStatus::wireEncode(EncodingImpl<TAG>& encoder) const
+{
+  size_t totalLength = 0;
+
+  if (isSuppressed()) {
+    totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::ReuseIn,
+                                                  static_cast<uint64_t>(m_reuseIn.count()));
+  }
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::Penalty, m_penalty);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::DampingKind, m_kind);
+  totalLength += m_name.wireEncode(encoder);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::ndvr::DampingStatus);
+  return totalLength;
+}
+
+NDN_CXX_DEFINE_WIRE_ENCODE_INSTANTIATIONS(DampingStatus);
+
+const Block&
+DampingStatus::wireEncode() const
+{
+  if (m_wire.hasWire())
+    return m_wire;
+
+  EncodingEstimator estimator;
+  size_t estimatedSize = wireEncode(estimator);
+
+  EncodingBuffer buffer(estimatedSize, 0);
+  wireEncode(buffer);
+
+  m_wire = buffer.block();
+  return m_wire;
+}
+
+void
+DampingStatus::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::ndvr::DampingStatus) {
+    NDN_THROW(Error("DampingStatus", wire.type()));
+  }
+  m_wire = wire;
+  m_wire.parse();
+
+  m_name.clear();
+  m_kind = DAMPING_PREFIX;
+  m_penalty = 0;
+  m_reuseIn = time::milliseconds::zero();
+
+  auto val = m_wire.elements_begin();
+  if (val == m_wire.elements_end() || val->type() != tlv::Name) {
+    NDN_THROW(Error("Missing Name in DampingStatus"));
+  }
+  m_name.wireDecode(*val);
+  for (++val; val != m_wire.elements_end(); ++val) {
+    switch (val->type()) {
+      case tlv::ndvr::DampingKind:
+        m_kind = static_cast<DampingKind>(readNonNegativeInteger(*val));
+        break;
+      case tlv::ndvr::Penalty:
+        m_penalty = readNonNegativeInteger(*val);
+        break;
+      case tlv::ndvr::ReuseIn:
+        m_reuseIn = time::milliseconds(readNonNegativeInteger(*val));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+template<encoding::Tag TAG>
+static size_t
+encodeRouteChange(EncodingImpl<TAG>& encoder, const RouteChange& change)
+{
+  size_t totalLength = 0;
+
+  if (change.kind != ROUTE_REMOVED) {
+    totalLength += prependNonNegativeIntegerBlock(encoder, tlv::nfd::Cost, change.cost);
+    totalLength += prependNonNegativeIntegerBlock(encoder, tlv::nfd::FaceId, change.faceId);
+  }
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::ChangeKind, change.kind);
+  totalLength += change.prefix.wireEncode(encoder);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::ndvr::RouteChange);
+  return totalLength;
+}
+
+static RouteChange
+decodeRouteChange(const Block& wire)
+{
+  if (wire.type() != tlv::ndvr::RouteChange) {
+    NDN_THROW(RouteChangeBatch::Error("RouteChange", wire.type()));
+  }
+  wire.parse();
+
+  RouteChange change;
+  auto val = wire.elements_begin();
+  if (val == wire.elements_end() || val->type() != tlv::Name) {
+    NDN_THROW(RouteChangeBatch::Error("Missing Name in RouteChange"));
+  }
+  change.prefix.wireDecode(*val);
+  bool hasKind = false;
+  for (++val; val != wire.elements_end(); ++val) {
+    switch (val->type()) {
+      case tlv::ndvr::ChangeKind:
+        change.kind = static_cast<RouteChangeKind>(readNonNegativeInteger(*val));
+        hasKind = true;
+        break;
+      case tlv::nfd::FaceId:
+        change.faceId = readNonNegativeInteger(*val);
+        break;
+      case tlv::nfd::Cost:
+        change.cost = readNonNegativeIntegerAs<uint32_t>(*val);
+        break;
+      default:
+        break;
+    }
+  }
+  if (!hasKind) {
+    NDN_THROW(RouteChangeBatch::Error("Missing ChangeKind in RouteChange"));
+  }
+  return change;
+}
+
+RouteChangeBatch&
+RouteChangeBatch::setSeqNum(uint64_t seqNum)
+{
+  m_wire.reset();
+  m_seqNum = seqNum;
+  return *this;
+}
+
+RouteChangeBatch&
+RouteChangeBatch::setVersion(uint64_t version)
+{
+  m_wire.reset();
+  m_version = version;
+  return *this;
+}
+
+RouteChangeBatch&
+RouteChangeBatch::addChange(const RouteChange& change)
+{
+  m_wire.reset();
+  m_changes.push_back(change);
+  return *this;
+}
+
+template<encoding::Tag TAG>
+size_t
+RouteChangeBatch::wireEncode(EncodingImpl<TAG>& encoder) const
+{
+  size_t totalLength = 0;
+
+  for (auto it = m_changes.rbegin(); it != m_changes.rend(); ++it) {
+    totalLength += encodeRouteChange(encoder, *it);
+  }
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::Version, m_version);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::ndvr::SeqNum, m_seqNum);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::ndvr::RouteChangeBatch);
+  return totalLength;
+}
+
+NDN_CXX_DEFINE_WIRE_ENCODE_INSTANTIATIONS(RouteChangeBatch);
+
+const Block&
+RouteChangeBatch::wireEncode() const
+{
+  if (m_wire.hasWire())
+    return m_wire;
+
+  EncodingEstimator estimator;
+  size_t estimatedSize = wireEncode(estimator);
+
+  EncodingBuffer buffer(estimatedSize, 0);
+  wireEncode(buffer);
+
+  m_wire = buffer.block();
+  return m_wire;
+}
+
+void
+RouteChangeBatch::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::ndvr::RouteChangeBatch) {
+    NDN_THROW(Error("RouteChangeBatch", wire.type()));
+  }
+  m_wire = wire;
+  m_wire.parse();
+
+  m_seqNum = m_version = 0;
+  m_changes.clear();
+
+  bool hasSeqNum = false;
+  for (const auto& element : m_wire.elements()) {
+    switch (element.type()) {
+      case tlv::ndvr::SeqNum:
+        m_seqNum = readNonNegativeInteger(element);
+        hasSeqNum = true;
+        break;
+      case tlv::ndvr::Version:
+        m_version = readNonNegativeInteger(element);
+        break;
+      case tlv::ndvr::RouteChange:
+        m_changes.push_back(decodeRouteChange(element));
+        break;
+      default:
+        break;
+    }
+  }
+  if (!hasSeqNum) {
+    NDN_THROW(Error("Missing SeqNum in RouteChangeBatch"));
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const RouteStatus& status)
+{
+  os << "prefix=" << status.getPrefix()
+     << " seq=" << status.getSeqNum()
+     << " originator=" << status.getOriginator()
+     << " nexthops={";
+  bool first = true;
+  for (const auto& nextHop : status.getNextHops()) {
+    if (!first)
+      os << ", ";
+    first = false;
+    os << "faceid=" << nextHop.faceId << " (cost=" << nextHop.cost;
+    if (!nextHop.neighbor.empty())
+      os << " via " << nextHop.neighbor;
+    if (nextHop.stale)
+      os << " stale";
+    os << ")";
+  }
+  return os << "}";
+}
+
+std::ostream&
+operator<<(std::ostream& os, const NeighborStatus& status)
+{
+  return os << "neighbor=" << status.getName()
+            << " faceid=" << status.getFaceId()
+            << " version=" << status.getVersion()
+            << " dvinfo-version=" << status.getDvInfoVersion()
+            << " last-seen=" << status.getLastSeen().count() << "ms";
+}
+
+std::ostream&
+operator<<(std::ostream& os, const DampingStatus& status)
+{
+  os << (status.getKind() == DAMPING_NEIGHBOR ? "neighbor=" : "prefix=") << status.getName()
+     << " penalty=" << status.getPenalty();
+  if (status.isSuppressed())
+    os << " suppressed reuse-in=" << status.getReuseIn().count() << "ms";
+  return os;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const RouteChangeBatch& batch)
+{
+  os << "seq=" << batch.getSeqNum() << " version=" << batch.getVersion();
+  for (const auto& change : batch.getChanges()) {
+    os << std::endl << "  ";
+    switch (change.kind) {
+      case ROUTE_ADDED:
+        os << "added ";
+        break;
+      case ROUTE_REMOVED:
+        os << "removed ";
+        break;
+      case ROUTE_BEST_CHANGED:
+        os << "best-changed ";
+        break;
+      default:
+        os << "kind=" << static_cast<int>(change.kind) << " ";
+        break;
+    }
+    os << change.prefix;
+    if (change.kind != ROUTE_REMOVED)
+      os << " faceid=" << change.faceId << " cost=" << change.cost;
+  }
+  return os;
+}
+
+} // namespace ndvr
+} // namespace ndn
@@ -0,0 +1,432 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_STATUS_HPP
+#define NDVR_STATUS_HPP
+
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+namespace ndn {
+namespace tlv {
+namespace ndvr {
+
+/** @brief TLV-TYPEs of the /localhost/ndvr status datasets and notifications
+ *
+ *    RouteStatus    := ROUTE-STATUS-TYPE TLV-LENGTH
+ *                        Name
+ *                        SeqNum
+ *                        Originator
+ *                        NextHopRecord*
+ *    NextHopRecord  := NEXT-HOP-RECORD-TYPE TLV-LENGTH
+ *                        FaceId
+ *                        Cost
+ *                        Neighbor
+ *                        Stale?
+ *    NeighborStatus := NEIGHBOR-STATUS-TYPE TLV-LENGTH
+ *                        Name
+ *                        FaceId
+ *                        Version
+ *                        DvInfoVersion
+ *                        LastSeen (milliseconds ago)
+ *    DampingStatus  := DAMPING-STATUS-TYPE TLV-LENGTH
+ *                        Name
+ *                        DampingKind
+ *                        Penalty
+ *                        ReuseIn? (milliseconds, when suppressed)
+ *    NextPage       := NEXT-PAGE-TYPE TLV-LENGTH <key of the last entry>
+ *
+ *    RouteChangeBatch := ROUTE-CHANGE-BATCH-TYPE TLV-LENGTH
+ *                          SeqNum (of the batch, consecutive)
+ *                          Version (of the routing table)
+ *                          RouteChange*
+ *    RouteChange      := ROUTE-CHANGE-TYPE TLV-LENGTH
+ *                          Name
+ *                          ChangeKind
+ *                          FaceId? Cost? (best next hop, unless removed)
+ *
+ * FaceId and Cost are the NFD management ones (tlv::nfd).
+ */
+enum {
+  RouteStatus    = 200,
+  NextHopRecord  = 201,
+  NeighborStatus = 202,
+  SeqNum         = 203,
+  Originator     = 204,
+  Neighbor       = 205,
+  Stale          = 206,
+  Version        = 207,
+  DvInfoVersion  = 208,
+  LastSeen       = 209,
+  NextPage       = 210,
+  RouteChangeBatch = 211,
+  RouteChange      = 212,
+  ChangeKind       = 213,
+  DampingStatus    = 214,
+  DampingKind      = 215,
+  Penalty          = 216,
+  ReuseIn          = 217,
+};
+
+} // namespace ndvr
+} // namespace tlv
+
+namespace ndvr {
+
+/** @brief One next hop of a RouteStatus */
+struct NextHopRecord
+{
+  uint64_t faceId = 0;
+  uint32_t cost = 0;
+  std::string neighbor;
+  /* restored from a snapshot, not refreshed by the neighbor yet */
+  bool stale = false;
+};
+
+/** @brief A routing table entry, as listed by /localhost/ndvr/routes */
+class RouteStatus
+{
+public:
+  class Error : public tlv::Error
+  {
+  public:
+    using tlv::Error::Error;
+  };
+
+  RouteStatus() = default;
+
+  explicit
+  RouteStatus(const Block& block)
+  {
+    wireDecode(block);
+  }
+
+  const Name&
+  getPrefix() const
+  {
+    return m_prefix;
+  }
+
+  RouteStatus&
+  setPrefix(const Name& prefix);
+
+  uint64_t
+  getSeqNum() const
+  {
+    return m_seqNum;
+  }
+
+  RouteStatus&
+  setSeqNum(uint64_t seqNum);
+
+  const std::string&
+  getOriginator() const
+  {
+    return m_originator;
+  }
+
+  RouteStatus&
+  setOriginator(const std::string& originator);
+
+  const std::vector<NextHopRecord>&
+  getNextHops() const
+  {
+    return m_nextHops;
+  }
+
+  RouteStatus&
+  addNextHop(const NextHopRecord& nextHop);
+
+  template<encoding::Tag TAG>
+  size_t
+  wireEncode(EncodingImpl<TAG>& encoder) const;
+
+  const Block&
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  Name m_prefix;
+  uint64_t m_seqNum = 0;
+  std::string m_originator;
+  std::vector<NextHopRecord> m_nextHops;
+
+  mutable Block m_wire;
+};
+
+/** @brief A neighbor, as listed by /localhost/ndvr/neighbors */
+class NeighborStatus
+{
+public:
+  class Error : public tlv::Error
+  {
+  public:
+    using tlv::Error::Error;
+  };
+
+  NeighborStatus() = default;
+
+  explicit
+  NeighborStatus(const Block& block)
+  {
+    wireDecode(block);
+  }
+
+  const Name&
+  getName() const
+  {
+    return m_name;
+  }
+
+  NeighborStatus&
+  setName(const Name& name);
+
+  uint64_t
+  getFaceId() const
+  {
+    return m_faceId;
+  }
+
+  NeighborStatus&
+  setFaceId(uint64_t faceId);
+
+  uint64_t
+  getVersion() const
+  {
+    return m_version;
+  }
+
+  NeighborStatus&
+  setVersion(uint64_t version);
+
+  uint64_t
+  getDvInfoVersion() const
+  {
+    return m_dvInfoVersion;
+  }
+
+  NeighborStatus&
+  setDvInfoVersion(uint64_t version);
+
+  time::milliseconds
+  getLastSeen() const
+  {
+    return m_lastSeen;
+  }
+
+  NeighborStatus&
+  setLastSeen(time::milliseconds lastSeen);
+
+  template<encoding::Tag TAG>
+  size_t
+  wireEncode(EncodingImpl<TAG>& encoder) const;
+
+  const Block&
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  Name m_name;
+  uint64_t m_faceId = 0;
+  uint64_t m_version = 0;
+  uint64_t m_dvInfoVersion = 0;
+  time::milliseconds m_lastSeen = time::milliseconds::zero();
+
+  mutable Block m_wire;
+};
+
+enum DampingKind {
+  DAMPING_PREFIX   = 1,
+  DAMPING_NEIGHBOR = 2,
+};
+
+/** @brief A flapping prefix or neighbor, as listed by /localhost/ndvr/damping
+ *
+ * Suppressed while getReuseIn() is not zero.
+ */
+class DampingStatus
+{
+public:
+  class Error : public tlv::Error
+  {
+  public:
+    using tlv::Error::Error;
+  };
+
+  DampingStatus() = default;
+
+  explicit
+  DampingStatus(const Block& block)
+  {
+    wireDecode(block);
+  }
+
+  const Name&
+  getName() const
+  {
+    return m_name;
+  }
+
+  DampingStatus&
+  setName(const Name& name);
+
+  DampingKind
+  getKind() const
+  {
+    return m_kind;
+  }
+
+  DampingStatus&
+  setKind(DampingKind kind);
+
+  uint64_t
+  getPenalty() const
+  {
+    return m_penalty;
+  }
+
+  DampingStatus&
+  setPenalty(uint64_t penalty);
+
+  bool
+  isSuppressed() const
+  {
+    return m_reuseIn > time::milliseconds::zero();
+  }
+
+  time::milliseconds
+  getReuseIn() const
+  {
+    return m_reuseIn;
+  }
+
+  DampingStatus&
+  setReuseIn(time::milliseconds reuseIn);
+
+  template<encoding::Tag TAG>
+  size_t
+  wireEncode(EncodingImpl<TAG>& encoder) const;
+
+  const Block&
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  Name m_name;
+  DampingKind m_kind = DAMPING_PREFIX;
+  uint64_t m_penalty = 0;
+  time::milliseconds m_reuseIn = time::milliseconds::zero();
+
+  mutable Block m_wire;
+};
+
+enum RouteChangeKind {
+  ROUTE_ADDED        = 1,
+  ROUTE_REMOVED      = 2,
+  /* still reachable, through another best next hop or at another cost */
+  ROUTE_BEST_CHANGED = 3,
+};
+
+/** @brief One change of a RouteChangeBatch */
+struct RouteChange
+{
+  Name prefix;
+  RouteChangeKind kind = ROUTE_ADDED;
+  uint64_t faceId = 0;
+  uint32_t cost = 0;
+};
+
+/** @brief Route changes of one event-loop tick, as published on
+ *         /localhost/ndvr/route-events
+ *
+ * Batches are numbered consecutively from 1. A subscriber that sees a gap
+ * (or joins late) lost changes and should fetch the routes dataset again.
+ */
+class RouteChangeBatch
+{
+public:
+  class Error : public tlv::Error
+  {
+  public:
+    using tlv::Error::Error;
+  };
+
+  RouteChangeBatch() = default;
+
+  explicit
+  RouteChangeBatch(const Block& block)
+  {
+    wireDecode(block);
+  }
+
+  uint64_t
+  getSeqNum() const
+  {
+    return m_seqNum;
+  }
+
+  RouteChangeBatch&
+  setSeqNum(uint64_t seqNum);
+
+  uint64_t
+  getVersion() const
+  {
+    return m_version;
+  }
+
+  RouteChangeBatch&
+  setVersion(uint64_t version);
+
+  const std::vector<RouteChange>&
+  getChanges() const
+  {
+    return m_changes;
+  }
+
+  RouteChangeBatch&
+  addChange(const RouteChange& change);
+
+  template<encoding::Tag TAG>
+  size_t
+  wireEncode(EncodingImpl<TAG>& encoder) const;
+
+  const Block&
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  uint64_t m_seqNum = 0;
+  uint64_t m_version = 0;
+  std::vector<RouteChange> m_changes;
+
+  mutable Block m_wire;
+};
+
+std::ostream&
+operator<<(std::ostream& os, const RouteStatus& status);
+
+std::ostream&
+operator<<(std::ostream& os, const NeighborStatus& status);
+
+std::ostream&
+operator<<(std::ostream& os, const DampingStatus& status);
+
+std::ostream&
+operator<<(std::ostream& os, const RouteChangeBatch& batch);
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_STATUS_HPP
@@ -4,7 +4,9 @@
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/uuid/detail/sha1.hpp>
+#include <cerrno>
 #include <cmath>
+#include <cstring>
 #include <limits>
 // #include <ns3/simulator.h>
 // #include <ns3/log.h>
@@ -13,6 +15,7 @@
 // #include <ns3/node-list.h>
 // #include <ns3/ndnSIM/helper/ndn-stack-helper.hpp>
 #include <ndn-cxx/lp/tags.hpp>
+#include <ndn-cxx/security/verification-helpers.hpp>
 
 // #include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
 // #include "ns3/ndnSIM/NFD/daemon/face/generic-link-service.hpp"
@@ -47,12 +50,14 @@ void update_curtime() {
 namespace ndn {
 namespace ndvr {
 
-Ndvr::Ndvr(const ndn::security::SigningInfo &signingInfo, Name network,
+Ndvr::Ndvr(ndn::Face &face, ndn::KeyChain &keyChain,
+           const ndn::security::SigningInfo &signingInfo, Name network,
            Name routerName, std::vector<std::string> &npv,
            std::vector<std::string> &faces,
            std::vector<std::string> &monitorFaces, std::string validationConfig)
-    : m_signingInfo(signingInfo), m_scheduler(m_face.getIoService()),
-      m_validator(m_face), m_seq(0),
+    : m_signingInfo(signingInfo), m_face(face), m_keyChain(keyChain),
+      m_scheduler(m_face.getIoService()),
+      m_validator(makeCertificateFetcher()), m_seq(0),
       m_rand_nonce(0, std::numeric_limits<int>::max()),
       m_rand_backoff(1, 19999), m_network(network), m_routerName(routerName),
       m_listenFaces(faces), m_facesToBeMonitored(monitorFaces),
@@ -61,26 +66,23 @@ Ndvr::Ndvr(const ndn::security::SigningInfo &signingInfo, Name network,
       //, m_helloIntervalMax(60)
       ,
       m_localRTInterval(1), m_localRTTimeout(1), m_rengine(rdevice_()),
-      m_pivot(m_neighMap.end()), m_faceMonitor(m_face) {
+      m_pivot(m_neighMap.end()), m_faceMonitor(m_face),
+      m_dvInfoSigner(make_shared<KeyChainDvInfoSigner>(m_keyChain, m_signingInfo)) {
   buildRouterPrefix();
 
   try {
-    m_validator.load(validationConfig);
+    m_validator.load(getParsedValidationConfig(validationConfig),
+                     validationConfig);
   } catch (const std::exception &e) {
     throw Error("Failed to load validation rules file=" + validationConfig +
                 " Error=" + e.what());
   }
 
-  for (std::vector<std::string>::iterator it = npv.begin(); it != npv.end();
-       ++it) {
-    RoutingEntry routingEntry;
-    routingEntry.SetName(*it);
-    routingEntry.SetSeqNum(2);
-    routingEntry.UpsertNextHop(0, 0, ""); /* directly connected */
-    // routingEntry.SetFaceId(0); /* directly connected */
-    routingEntry.SetOriginator(m_routerPrefix.toUri()); /* directly connected */
-    m_routingTable.insert(routingEntry);
-  }
+  std::vector<NamePrefixUpdate> initialPrefixes;
+  initialPrefixes.reserve(npv.size());
+  for (const auto &name : npv)
+    initialPrefixes.push_back({name, false});
+  UpdateNamePrefixes(initialPrefixes);
 
   m_routingTable.enableLocalFields();
   m_routingTable.setMulticastStrategy(kNdvrPrefix.toUri());
@@ -99,6 +101,7 @@ void Ndvr::Start() {
       [this](const Name &, const std::string &reason) {
         throw Error("Failed to register sync interest prefix: " + reason);
       });
+  ReloadCertificates();
   Name routerKey = m_routerPrefix;
   routerKey.append("KEY");
   m_face.setInterestFilter(
@@ -109,6 +112,12 @@ void Ndvr::Start() {
 
   registerPrefixes();
 
+  if (!m_snapshotFile.empty()) {
+    LoadSnapshot();
+    savesnapshot_event = m_scheduler.schedule(m_snapshotInterval,
+                                              [this] { SaveSnapshot(); });
+  }
+
   m_faceMonitor.onNotification.connect(
       std::bind(&Ndvr::onFaceEventNotification, this, _1));
   m_faceMonitor.start();
@@ -116,7 +125,13 @@ void Ndvr::Start() {
   SendHelloInterest();
 }
 
-void Ndvr::Stop() {}
+void Ndvr::Stop() {
+  if (!m_snapshotFile.empty())
+    SaveSnapshot();
+  savesnapshot_event.cancel();
+  flushstale_event.cancel();
+  expirewithdrawals_event.cancel();
+}
 
 void Ndvr::run() { m_face.processEvents(); }
 
@@ -361,6 +376,11 @@ void Ndvr::RemoveNeighbor(const std::string neigh) {
   if (neigh_it == m_neighMap.end()) {
     return;
   }
+  m_neighborDamping.expire();
+  if (m_neighborDamping.addFlap(neigh)) {
+    NS_LOG_INFO("Neighbor " << neigh << " is flapping, suppressed for "
+                            << m_neighborDamping.getReuseDelay(neigh));
+  }
 
   bool has_changed = false;
 
@@ -368,11 +388,15 @@ void Ndvr::RemoveNeighbor(const std::string neigh) {
   // increase the cost)
   for (auto it = m_routingTable.begin(); it != m_routingTable.end(); ++it) {
     if (it->second.isNextHop(neigh_it->second.GetFaceId())) {
+      bool reachable = it->second.GetNextHopsSize() > 0;
       it->second.SetNextHopCost(neigh_it->second.GetFaceId(),
                                 std::numeric_limits<uint32_t>::max());
+      if (reachable && it->second.GetNextHopsSize() == 0)
+        RecordPrefixFlap(it->first);
       m_routingTable.unregisterPrefix(it->first, neigh_it->second.GetFaceId());
       it->second.GetPathVectors().deletePath(neigh_it->second.GetFaceId());
       it->second.IncSeqNum(1);
+      m_routingTable.NotifyChange(it->first);
       has_changed = true;
     }
     /* For local routes, increment the seqNum by 2 */
@@ -388,6 +412,7 @@ void Ndvr::RemoveNeighbor(const std::string neigh) {
 
   // remove from neighbor map
   m_neighMap.erase(neigh);
+  m_staleRoutes.erase(neigh);
   m_pivot = m_neighMap.end();
 
   // insert into recently removed
@@ -509,6 +534,13 @@ uint64_t Ndvr::ExtractIncomingFace(const ndn::Data &data) {
 }
 
 void Ndvr::processInterest(const ndn::Interest &interest) {
+  const Block &nameWire = interest.getName().wireEncode();
+  if (m_duplicateFilter.isDuplicate(nameWire.wire(), nameWire.size(),
+                                    interest.getNonce())) {
+    NS_LOG_DEBUG("Discarding duplicate Interest " << interest.getName());
+    return;
+  }
+
   uint64_t inFaceId = ExtractIncomingFace(interest);
   if (!inFaceId) {
     // NS_LOG_DEBUG("Discarding Interest from internal face: " << interest);
@@ -576,6 +608,11 @@ void Ndvr::OnHelloInterest(const ndn::Interest &interest, uint64_t inFaceId) {
 
   auto neigh = m_neighMap.find(neighPrefix);
   bool newNeigh = false;
+  if (neigh == m_neighMap.end() &&
+      m_neighborDamping.isSuppressed(neighPrefix)) {
+    NS_LOG_INFO("Neighbor " << neighPrefix << " is flapping, ignoring...");
+    return;
+  }
   if (neigh == m_neighMap.end()) {
     // ResetHelloInterval();
     uint64_t neighFaceId = 0;
@@ -619,6 +656,17 @@ void Ndvr::OnHelloInterest(const ndn::Interest &interest, uint64_t inFaceId) {
   }
   UpdateNeighHelloTimeout(neigh->second);
   RescheduleNeighRemoval(neigh->second);
+  /* routes restored from a snapshot through this neighbor: the version
+   * they came from confirms them, a newer one is fetched below */
+  if (m_staleRoutes.count(neighPrefix) != 0) {
+    if (version == neigh->second.GetDvInfoVersion()) {
+      NS_LOG_INFO("Snapshot routes via " << neighPrefix << " confirmed");
+      m_staleRoutes.erase(neighPrefix);
+    } else if (version < neigh->second.GetVersion()) {
+      /* the neighbor restarted without its state: fetch it anyway */
+      neigh->second.SetVersion(0);
+    }
+  }
   // if (numPrefixes > 0 && (newNeigh || version > neigh->second.GetVersion())
   // && numPrefixes >= m_routingTable.size()) {
   if (numPrefixes > 0 && (newNeigh || version > neigh->second.GetVersion())) {
@@ -627,6 +675,7 @@ void Ndvr::OnHelloInterest(const ndn::Interest &interest, uint64_t inFaceId) {
     /* does we really have a change? */
     if (digest != "0" && digest == m_routingTable.GetDigest()) {
       NS_LOG_INFO("Same digest, so there was no change! digest=" << digest);
+      m_staleRoutes.erase(neighPrefix);
       return;
     }
 
@@ -679,34 +728,61 @@ void Ndvr::ReplyDvInfoInterest(const ndn::Interest &interest) {
   data->setContent(
       make_span(reinterpret_cast<const uint8_t *>(dvinfo_str.c_str()),
                 dvinfo_str.size()));
-  // Sign and send
-  m_keyChain.sign(*data, m_signingInfo);
-  // m_keyChain.sign(*data);
-  NS_LOG_INFO("Replying DV-Info success!");
-  m_face.put(*data);
+  // Sign (off the event loop when there is a crypto pool) and send
+  auto signer = m_dvInfoSigner;
+  runOnWorker([signer, data] { signer->sign(*data); },
+              [this, data] {
+                NS_LOG_INFO("Replying DV-Info success!");
+                m_face.put(*data);
+              });
 }
 
 void Ndvr::OnKeyInterest(const ndn::Interest &interest) {
   NS_LOG_INFO("Received KEY Interest " << interest.getName());
-  std::string nameStr = interest.getName().toUri();
-  std::size_t pos = nameStr.find("/KEY/");
-  ndn::Name identityName = ndn::Name(nameStr.substr(0, pos));
 
-  try {
-    // Create Data packet
-    ndn::security::v2::Certificate cert = m_keyChain.getPib()
-                                              .getIdentity(identityName)
-                                              .getDefaultKey()
-                                              .getDefaultCertificate();
+  auto cert = m_certStore.find(interest.getName());
+  /* a miss may be a certificate installed after the last reload, but
+   * only for a key (or certificate) name of our own identity: anything
+   * else a neighbor asks for would not be found in the PIB either */
+  if (cert == nullptr && isOwnKeyName(interest.getName()) &&
+      time::steady_clock::now() - m_certStoreLoadTime >=
+          kCertStoreMinReloadInterval) {
+    ReloadCertificates();
+    cert = m_certStore.find(interest.getName());
+  }
+  if (cert == nullptr) {
+    NS_LOG_DEBUG("The certificate: " << interest.getName()
+                                     << " does not exist!");
+    return;
+  }
+
+  // Return Data packet to the requester
+  m_face.put(*cert);
+}
 
-    // Return Data packet to the requester
-    m_face.put(cert);
-  } catch (const std::exception &) {
-    NS_LOG_DEBUG("The certificate: "
-                 << interest.getName()
-                 << " does not exist! I was looking for Identity="
-                 << identityName);
+bool Ndvr::isOwnKeyName(const Name &name) const {
+  /* <identity>/KEY/<keyId>[/<issuerId>[/<version>]] */
+  size_t keyIndex = m_routerPrefix.size();
+  return name.size() >= keyIndex + 2 && name.size() <= keyIndex + 4 &&
+         m_routerPrefix.isPrefixOf(name) &&
+         name.get(keyIndex) == security::v2::Certificate::KEY_COMPONENT;
+}
+
+void Ndvr::ReloadCertificates() {
+  m_certStoreLoadTime = time::steady_clock::now();
+  try {
+    m_certStore.reload(m_keyChain, m_routerPrefix);
+  } catch (const std::exception &e) {
+    NS_LOG_WARN("Failed to load certificates of " << m_routerPrefix << ": "
+                                                  << e.what());
   }
+  NS_LOG_DEBUG("Loaded " << m_certStore.size() << " certificate(s) of "
+                         << m_routerPrefix);
+
+  /* pick up keychain changes (new or renewed certificate) */
+  reloadcerts_event.cancel();
+  reloadcerts_event = m_scheduler.schedule(kCertStoreReloadInterval,
+                                           [this] { ReloadCertificates(); });
 }
 
 void Ndvr::OnDvInfoTimedOut(const ndn::Interest &interest, uint32_t retx) {
@@ -771,19 +847,137 @@ void Ndvr::OnDvInfoContent(const ndn::Interest &interest,
     return;
   }
 
+  /* routes are applied in the order the DvInfo arrived, whatever the
+   * time their validation takes (e.g., a certificate to fetch) */
+  uint64_t seq = m_dvInfoSeqNext++;
+
   /* Security validation */
   if (data.getSignatureInfo().hasKeyLocator()) {
     NS_LOG_DEBUG("Data signed with: "
                  << data.getSignatureInfo().getKeyLocator().getName());
   }
 
+  /* the very same DvInfo (same implicit digest) was already validated,
+   * e.g. received from another neighbor or retransmitted */
+  if (m_validationCache.contains(data)) {
+    NS_LOG_DEBUG("DvInfo found in validation cache: " << data.getName());
+    OnValidatedDvInfo(data, seq);
+    return;
+  }
+
+  auto dataPtr = std::make_shared<ndn::Data>(data);
+  auto verified = std::make_shared<bool>(false);
+  auto onVerified = [this, dataPtr, verified, seq] {
+    if (!*verified) {
+      NS_LOG_DEBUG("Not validated data: " << dataPtr->getName()
+                                          << ". Bad signature");
+      DiscardPendingDvInfo(seq);
+      return;
+    }
+    m_validationCache.insert(*dataPtr);
+    OnValidatedDvInfo(*dataPtr, seq);
+  };
+
+  /* schemes the validator does not handle (e.g., shared-key HMAC) */
+  if (m_dvInfoSigner->canVerify(data)) {
+    auto signer = m_dvInfoSigner;
+    runOnWorker([signer, dataPtr,
+                 verified] { *verified = signer->verify(*dataPtr); },
+                onVerified);
+    return;
+  }
+
+  /* the validator already accepted this neighbor's key: only the
+   * signature is left to check, which does not need the event loop */
+  const auto &sigInfo = data.getSignatureInfo();
+  if (sigInfo.hasKeyLocator() &&
+      sigInfo.getKeyLocator().getType() == tlv::Name) {
+    auto publicKey = m_verifiedKeys.find(sigInfo.getKeyLocator().getName(),
+                                         neighPrefix,
+                                         sigInfo.getSignatureType());
+    if (publicKey != nullptr) {
+      runOnWorker(
+          [publicKey, dataPtr, verified] {
+            *verified = security::verifySignature(
+                *dataPtr, publicKey->data(), publicKey->size());
+          },
+          onVerified);
+      return;
+    }
+  }
+
   // Validating data
   m_validator.validate(
-      data, std::bind(&Ndvr::OnValidatedDvInfo, this, _1),
-      std::bind(&Ndvr::OnDvInfoValidationFailed, this, _1, _2));
+      data,
+      [this, seq](const ndn::Data &data) {
+        RememberVerifiedKey(data);
+        m_validationCache.insert(data);
+        OnValidatedDvInfo(data, seq);
+      },
+      std::bind(&Ndvr::OnDvInfoValidationFailed, this, _1, _2, seq));
+}
+
+void Ndvr::RememberVerifiedKey(const ndn::Data &data) {
+  const auto &sigInfo = data.getSignatureInfo();
+  if (!sigInfo.hasKeyLocator() ||
+      sigInfo.getKeyLocator().getType() != tlv::Name)
+    return;
+  const Name &keyName = sigInfo.getKeyLocator().getName();
+  /* the chain just validated: its certificates are in the validator's
+   * verified cache (or are trust anchors), retain them from there */
+  const security::v2::Certificate *cert = nullptr;
+  Name certKeyName = keyName;
+  for (int depth = 0; depth < kMaxRetainedChainDepth; ++depth) {
+    const security::v2::Certificate *chainCert = m_validator.findTrustedCert(
+        ndn::Interest(certKeyName).setCanBePrefix(true));
+    if (chainCert == nullptr)
+      break;
+    m_certFetcher->retain(*chainCert);
+    if (cert == nullptr)
+      cert = chainCert;
+    const auto &certSigInfo = chainCert->getSignatureInfo();
+    if (!certSigInfo.hasKeyLocator() ||
+        certSigInfo.getKeyLocator().getType() != tlv::Name ||
+        certSigInfo.getKeyLocator().getName().isPrefixOf(
+            chainCert->getName()))
+      break;
+    certKeyName = certSigInfo.getKeyLocator().getName();
+  }
+  if (cert == nullptr)
+    return;
+  /* the certificate found by key name was not necessarily the one the
+   * validator used: only trust it if its key signed this data */
+  const Buffer &publicKey = cert->getPublicKey();
+  if (!security::verifySignature(data, publicKey.data(), publicKey.size()))
+    return;
+  m_verifiedKeys.insert(keyName,
+                        ExtractRouterPrefix(data.getName(), kNdvrDvInfoPrefix),
+                        sigInfo.getSignatureType(), *cert);
 }
 
-void Ndvr::OnValidatedDvInfo(const ndn::Data &data) {
+std::unique_ptr<security::v2::CertificateFetcher>
+Ndvr::makeCertificateFetcher() {
+  auto fetcher = make_unique<RetainingCertificateFetcher>(m_face);
+  m_certFetcher = fetcher.get();
+  return std::move(fetcher);
+}
+
+void Ndvr::runOnWorker(std::function<void()> job, std::function<void()> done) {
+  if (m_cryptoPool == nullptr) {
+    job();
+    done();
+    return;
+  }
+  /* the completion may run after this instance is gone */
+  std::weak_ptr<int> guard = m_cryptoGuard;
+  m_cryptoPool->post(m_face.getIoService(), std::move(job),
+                     [guard, done] {
+                       if (!guard.expired())
+                         done();
+                     });
+}
+
+void Ndvr::OnValidatedDvInfo(const ndn::Data &data, uint64_t seq) {
   NS_LOG_DEBUG("Validated data: " << data.getName());
   std::string neighPrefix =
       ExtractRouterPrefix(data.getName(), kNdvrDvInfoPrefix);
@@ -792,37 +986,97 @@ void Ndvr::OnValidatedDvInfo(const ndn::Data &data) {
   auto neigh_it = m_neighMap.find(neighPrefix);
   if (neigh_it == m_neighMap.end()) {
     NS_LOG_INFO("Discard DvInfo from unknonw neighbor=" << neighPrefix);
+    DiscardPendingDvInfo(seq);
     return;
   }
 
   /* Update lastSeen and reschedule neighbor removal */
   RescheduleNeighRemoval(neigh_it->second);
 
-  /* Extract DvInfo and process Distance Vector update */
-  const auto &content = data.getContent();
+  /* Extract DvInfo and process Distance Vector update: parsing, decoding
+   * and path-vector loop filtering run on a worker (they only read the
+   * DvInfo), the result is applied to the routing table here, in the
+   * order the DvInfo arrived */
+  uint64_t faceId = neigh_it->second.GetFaceId();
+  auto content = data.getContent();
+  auto routerPrefix_Uri = m_routerPrefix.toUri();
+  auto decoded = std::make_shared<PendingDvInfo>();
+  decoded->neighPrefix = neighPrefix;
+  decoded->faceId = faceId;
+  const auto &versionComponent = data.getName().get(-1);
+  decoded->version =
+      versionComponent.isNumber() ? versionComponent.toNumber() : 0;
+  runOnWorker(
+      [decoded, content, routerPrefix_Uri] {
+        decoded->rt = PrepareDvInfo(content, decoded->faceId, routerPrefix_Uri);
+      },
+      [this, seq, decoded] {
+        m_dvInfoPending[seq] = std::move(*decoded);
+        ApplyPendingDvInfo();
+      });
+}
+
+std::shared_ptr<RoutingTable>
+Ndvr::PrepareDvInfo(const ndn::Block &content, uint64_t faceId,
+                    const std::string &routerPrefix_Uri) {
   proto::DvInfo dvinfo_proto;
-  // NS_LOG_DEBUG("Content: size=" << content.value_size());
-  // NS_LOG_INFO("Trying to parser  DV-Info...");
   if (!dvinfo_proto.ParseFromArray(content.value(), content.value_size())) {
-    NS_LOG_INFO("Invalid DvInfo content!!! Abort processing..");
-    return;
+    return nullptr;
+  }
+  auto otherRT = std::make_shared<RoutingTable>(DecodeDvInfo(dvinfo_proto));
+
+  /* fix FaceID and drop paths that already went through this router */
+  for (auto &entry : *otherRT) {
+    auto &pathVectors = entry.second.GetPathVectors();
+    pathVectors.setThisRouterPrefix(routerPrefix_Uri);
+    auto nexthops = pathVectors.getNextHops(0);
+    pathVectors.addPath(faceId, nexthops);
+    pathVectors.deletePath(0);
+  }
+  return otherRT;
+}
+
+void Ndvr::DiscardPendingDvInfo(uint64_t seq) {
+  /* nothing to apply, but the DvInfo that arrived after it may go */
+  m_dvInfoPending[seq].discarded = true;
+  ApplyPendingDvInfo();
+}
+
+void Ndvr::ApplyPendingDvInfo() {
+  /* single writer: apply in arrival order, waiting for slower
+   * validations and workers */
+  for (auto it = m_dvInfoPending.begin();
+       it != m_dvInfoPending.end() && it->first == m_dvInfoSeqApply;
+       it = m_dvInfoPending.erase(it), ++m_dvInfoSeqApply) {
+    PendingDvInfo &pending = it->second;
+    if (pending.discarded)
+      continue;
+    if (pending.rt == nullptr) {
+      NS_LOG_INFO("Invalid DvInfo content!!! Abort processing..");
+      continue;
+    }
+    auto neigh_it = m_neighMap.find(pending.neighPrefix);
+    if (neigh_it == m_neighMap.end()) {
+      NS_LOG_INFO("Discard DvInfo from removed neighbor="
+                  << pending.neighPrefix);
+      continue;
+    }
+    neigh_it->second.SetDvInfoVersion(pending.version);
+    processDvInfoFromNeighbor(neigh_it->second, *pending.rt, pending.faceId);
   }
-  // NS_LOG_INFO("Parser complete! dvinfo_proto content is:");
-  // for (int i = 0; i < dvinfo_proto.entry_size(); ++i) {
-  //   const auto& entry = dvinfo_proto.entry(i);
-  //   NS_LOG_INFO("DV-Info from neighbor prefix=" << entry.prefix() << "
-  //   seqNum=" << entry.seq() << " cost=" << entry.cost());
-  // }
-  // NS_LOG_INFO("Decoding...");
-  auto otherRT = DecodeDvInfo(dvinfo_proto);
-  processDvInfoFromNeighbor(neigh_it->second, otherRT);
-  // NS_LOG_INFO("Done");
 }
 
 void Ndvr::OnDvInfoValidationFailed(
-    const ndn::Data &data, const ndn::security::v2::ValidationError &ve) {
+    const ndn::Data &data, const ndn::security::v2::ValidationError &ve,
+    uint64_t seq) {
   NS_LOG_DEBUG("Not validated data: " << data.getName()
                                       << ". The failure info: " << ve);
+  DiscardPendingDvInfo(seq);
+  /* a retained certificate may be the culprit (e.g., revoked or
+   * replaced): fetch it again next time */
+  const auto &sigInfo = data.getSignatureInfo();
+  if (sigInfo.hasKeyLocator() && sigInfo.getKeyLocator().getType() == tlv::Name)
+    m_certFetcher->forget(sigInfo.getKeyLocator().getName());
 }
 
 void Ndvr::UpdateRoutingTableDigest() {
@@ -855,6 +1109,9 @@ void Ndvr::EncodeDvInfo(std::string &out) {
 
   for (auto it = m_routingTable.begin(); it != m_routingTable.end(); ++it) {
     auto &routingEntry = it->second;
+    /* announced through its aggregate */
+    if (routingEntry.IsSuppressed())
+      continue;
     NS_LOG_INFO("EncodeDvInfo() - routingEntry=" << routingEntry.GetName());
     PathVectors &pathVectors = routingEntry.GetPathVectors();
     if (pathVectors.begin() == pathVectors.end()) {
@@ -882,21 +1139,37 @@ void Ndvr::EncodeDvInfo(std::string &out) {
     }
     NS_LOG_INFO("EncodeDvInfo() - pathVectors= " << pathVectors);
   }
+  /* withdrawn prefixes: infinite cost and no path */
+  for (const auto &withdrawal : m_withdrawals) {
+    auto *entry = dvinfo_proto.add_entry();
+    entry->set_prefix(withdrawal.first);
+    entry->set_seq(withdrawal.second.seqNum);
+    entry->set_originator(withdrawal.second.originator);
+    entry->set_cost(std::numeric_limits<uint32_t>::max());
+    NS_LOG_INFO("EncodeDvInfo() - withdrawn=" << withdrawal.first);
+  }
   dvinfo_proto.AppendToString(&out);
   NS_LOG_INFO("EncodeDvInfo()= " << out);
 }
 
 void Ndvr::processDvInfoFromNeighbor(NeighborEntry &neighbor,
-                                     RoutingTable &otherRT) {
+                                     RoutingTable &otherRT,
+                                     uint64_t decodedFaceId) {
   NS_LOG_INFO("Process DvInfo from neighbor=" << neighbor.GetName());
 
-  bool has_changed = false;
+  /* restored routes this DvInfo no longer carries are withdrawn */
+  bool has_changed = DropStaleRoutes(neighbor.GetName(), &otherRT);
   std::string routerPrefix_Uri = m_routerPrefix.toUri();
+  /* a prefix under one of our aggregates is served by another router */
+  bool touches_aggregate = false;
 
   for (auto entry : otherRT) {
     std::string neigh_prefix = entry.first;
+    touches_aggregate = touches_aggregate || IsUnderAggregate(neigh_prefix);
     uint64_t neigh_seq = entry.second.GetSeqNum();
     uint32_t neigh_cost = entry.second.GetBestCost();
+    /* explicit withdrawal (see EncodeDvInfo) */
+    bool withdrawn = isInfinityCost(neigh_cost);
 
     NS_LOG_INFO(
         "DEBUG DE SOCORRO Custo da entrada em processDvInfoFromNeighbor "
@@ -906,12 +1179,14 @@ void Ndvr::processDvInfoFromNeighbor(NeighborEntry &neighbor,
                                 << " recvCost=" << neigh_cost << " learnedFrom="
                                 << entry.second.GetLearnedFrom());
 
-    // fix Incorrect FaceID - OK
+    // fix Incorrect FaceID - OK (unless PrepareDvInfo already did it)
     auto &pathVectors = entry.second.GetPathVectors();
-    pathVectors.setThisRouterPrefix(routerPrefix_Uri);
-    auto nexthops = pathVectors.getNextHops(0);
-    pathVectors.addPath(neighbor.GetFaceId(), nexthops);
-    pathVectors.deletePath(0);
+    if (decodedFaceId == 0 || decodedFaceId != neighbor.GetFaceId()) {
+      pathVectors.setThisRouterPrefix(routerPrefix_Uri);
+      auto nexthops = pathVectors.getNextHops(decodedFaceId);
+      pathVectors.addPath(neighbor.GetFaceId(), nexthops);
+      pathVectors.deletePath(decodedFaceId);
+    }
     NS_LOG_INFO(" ---> PathVectors: " << pathVectors);
 
     // TODO testar funcao abaixo
@@ -923,9 +1198,20 @@ void Ndvr::processDvInfoFromNeighbor(NeighborEntry &neighbor,
 
     /* insert new prefix */
     auto localRE = m_routingTable.LookupRoute(neigh_prefix);
+    /* flapping: not learned again until reused (ReuseDampedPrefixes) */
+    if (!withdrawn && (localRE == nullptr || localRE->GetNextHopsSize() == 0) &&
+        m_prefixDamping.isSuppressed(neigh_prefix))
+      continue;
     if (localRE == nullptr) {
       if (isInfinityCost(neigh_cost))
         continue;
+      /* not newer than a withdrawal we know of: a late announcement */
+      auto withdrawal = m_withdrawals.find(neigh_prefix);
+      if (withdrawal != m_withdrawals.end()) {
+        if (neigh_seq <= withdrawal->second.seqNum)
+          continue;
+        m_withdrawals.erase(withdrawal);
+      }
       NS_LOG_INFO("======>> New prefix! Just insert it "
                   << neigh_prefix << " via " << neighbor.GetFaceId());
       // entry.second.SetCost(CalculateCostToNeigh(neighbor, neigh_cost));
@@ -941,6 +1227,10 @@ void Ndvr::processDvInfoFromNeighbor(NeighborEntry &neighbor,
       // roteamento local
       auto &localREPathVector = localRE->GetPathVectors();
       localREPathVector.setThisRouterPrefix(routerPrefix_Uri);
+      if (withdrawn) {
+        /* the neighbor no longer has any path */
+        localREPathVector.deletePath(neighbor.GetFaceId());
+      }
       for (auto it = pathVectors.cbegin(); it != pathVectors.cend(); it++) {
         for (auto nextHop : it->second) {
           localREPathVector.addPath(it->first, nextHop);
@@ -1000,7 +1290,16 @@ void Ndvr::processDvInfoFromNeighbor(NeighborEntry &neighbor,
 
       NS_LOG_INFO("======>> Infinity cost! Remove nextHop for name prefix"
                   << neigh_prefix << " nextHop=" << neighbor.GetFaceId());
+      uint64_t seqNum = localRE->GetSeqNum();
+      std::string originator = localRE->GetOriginator();
+      bool reachable = localRE->GetNextHopsSize() > 0;
       m_routingTable.DeleteNextHop(*localRE, neighbor.GetFaceId());
+      localRE = m_routingTable.LookupRoute(neigh_prefix);
+      /* the last path is gone: pass the withdrawal on */
+      if (withdrawn && localRE == nullptr)
+        AddWithdrawal(neigh_prefix, seqNum, originator);
+      if (reachable && (localRE == nullptr || localRE->GetNextHopsSize() == 0))
+        RecordPrefixFlap(neigh_prefix);
 
       // Now that we removed a NextHop, we eventually need to update the
       // learnedFrom attribute to avoid local loops
@@ -1115,6 +1414,8 @@ void Ndvr::processDvInfoFromNeighbor(NeighborEntry &neighbor,
   }
 
   if (has_changed) {
+    if (touches_aggregate)
+      UpdateAggregates();
     m_routingTable.IncVersion();
     // UpdateRoutingTableDigest();
     /* schedule a immediate ehlo message to notify neighbors about a new DvInfo
@@ -1124,6 +1425,180 @@ void Ndvr::processDvInfoFromNeighbor(NeighborEntry &neighbor,
   }
 }
 
+void Ndvr::SaveSnapshot() {
+  std::vector<RoutingSnapshot::Neighbor> neighbors;
+  for (auto &neigh : m_neighMap) {
+    neighbors.push_back({neigh.first, neigh.second.GetFaceId(),
+                         neigh.second.GetDvInfoVersion()});
+  }
+  std::string data;
+  RoutingSnapshot::encode(data, m_routerPrefix.toUri(), m_routingTable,
+                          neighbors);
+  if (data != m_lastSnapshot) {
+    if (RoutingSnapshot::writeFile(m_snapshotFile, data)) {
+      m_lastSnapshot.swap(data);
+    } else {
+      std::string reason = std::strerror(errno);
+      NS_LOG_WARN("Failed to write routing snapshot " << m_snapshotFile << ": "
+                                                      << reason);
+    }
+  }
+
+  savesnapshot_event.cancel();
+  savesnapshot_event =
+      m_scheduler.schedule(m_snapshotInterval, [this] { SaveSnapshot(); });
+}
+
+void Ndvr::LoadSnapshot() {
+  std::string data;
+  time::system_clock::TimePoint mtime;
+  if (!RoutingSnapshot::readFile(m_snapshotFile, data, mtime)) {
+    NS_LOG_INFO("No routing snapshot " << m_snapshotFile << ", cold start");
+    return;
+  }
+  RoutingSnapshot snapshot;
+  if (!snapshot.decode(data)) {
+    NS_LOG_WARN("Ignoring corrupt routing snapshot " << m_snapshotFile);
+    return;
+  }
+  if (snapshot.routerPrefix != m_routerPrefix.toUri()) {
+    NS_LOG_WARN("Ignoring routing snapshot of another router: "
+                << snapshot.routerPrefix);
+    return;
+  }
+  if (time::system_clock::now() - mtime > kSnapshotMaxAge) {
+    NS_LOG_INFO("Ignoring routing snapshot older than " << kSnapshotMaxAge);
+    return;
+  }
+
+  /* our own prefixes are the configured ones, but keep the seqNums we
+   * announced, neighbors would discard lower ones */
+  bool localChanged = false;
+  for (auto it = m_routingTable.begin(); it != m_routingTable.end(); ++it) {
+    if (!it->second.isDirectRoute())
+      continue;
+    auto saved = snapshot.routes.find(it->first);
+    if (saved == snapshot.routes.end() || !saved->second.isDirectRoute()) {
+      localChanged = true;
+      continue;
+    }
+    if (saved->second.GetSeqNum() > it->second.GetSeqNum())
+      it->second.SetSeqNum(saved->second.GetSeqNum());
+    /* the withdrawal must beat the seqNum neighbors last heard */
+    if (it->second.IsSuppressed())
+      AddWithdrawal(it->first, it->second.GetSeqNum() + 1,
+                    it->second.GetOriginator());
+  }
+
+  for (const auto &saved : snapshot.neighbors) {
+    if (saved.name.empty() || saved.faceId == 0 ||
+        m_neighMap.find(saved.name) != m_neighMap.end())
+      continue;
+    auto neigh =
+        m_neighMap
+            .emplace(saved.name,
+                     NeighborEntry(saved.name, saved.faceId, saved.version))
+            .first;
+    neigh->second.SetDvInfoVersion(saved.version);
+    registerNeighborPrefix(neigh->second, 0, saved.faceId);
+    /* removed as usual if it does not say Hello again */
+    UpdateNeighHelloTimeout(neigh->second);
+    RescheduleNeighRemoval(neigh->second);
+  }
+  m_pivot = m_neighMap.end();
+
+  size_t nRoutes = 0;
+  for (auto &item : snapshot.routes) {
+    auto &saved = item.second;
+    if (m_routingTable.LookupRoute(item.first) != nullptr)
+      continue;
+    if (saved.isDirectRoute()) {
+      /* no longer configured */
+      localChanged = true;
+      continue;
+    }
+    RoutingEntry entry(item.first, saved.GetSeqNum());
+    entry.SetOriginator(saved.GetOriginator());
+    for (const auto &nh : saved.GetNextHops()) {
+      uint32_t cost = nh.cost;
+      const std::string &neighName = nh.neighName;
+      auto neigh = m_neighMap.find(neighName);
+      if (isInfinityCost(cost) || neigh == m_neighMap.end() ||
+          neigh->second.GetFaceId() != nh.faceId)
+        continue;
+      entry.UpsertNextHop(nh.faceId, cost, neighName);
+      auto paths = saved.GetPathVectors().getNextHops(nh.faceId);
+      entry.GetPathVectors().addPath(nh.faceId, paths);
+      m_routingTable.registerPrefix(item.first, nh.faceId, cost);
+      m_staleRoutes[neighName].insert(item.first);
+    }
+    if (entry.GetNextHopsSize() == 0)
+      continue;
+    m_routingTable.m_rt[item.first] = entry;
+    m_routingTable.NotifyChange(item.first);
+    nRoutes++;
+  }
+
+  m_routingTable.SetVersion(
+      std::max(snapshot.version, m_routingTable.GetVersion()));
+  if (localChanged)
+    m_routingTable.IncVersion();
+  else
+    m_routingTable.UpdateDigest();
+  NS_LOG_INFO("Restored " << nRoutes << " routes (stale until refreshed) and "
+                          << m_neighMap.size() << " neighbors from "
+                          << m_snapshotFile
+                          << " version=" << m_routingTable.GetVersion());
+
+  if (!m_staleRoutes.empty()) {
+    flushstale_event = m_scheduler.schedule(kStaleRouteTimeout,
+                                            [this] { FlushStaleRoutes(); });
+  }
+}
+
+bool Ndvr::DropStaleRoutes(const std::string &neigh,
+                           const RoutingTable *keep) {
+  auto stale = m_staleRoutes.find(neigh);
+  if (stale == m_staleRoutes.end())
+    return false;
+
+  bool has_changed = false;
+  auto neigh_it = m_neighMap.find(neigh);
+  if (neigh_it != m_neighMap.end()) {
+    uint64_t faceId = neigh_it->second.GetFaceId();
+    for (const auto &prefix : stale->second) {
+      if (keep != nullptr && keep->find(prefix) != keep->end())
+        continue;
+      auto localRE = m_routingTable.LookupRoute(prefix);
+      if (localRE == nullptr || !localRE->isNextHop(faceId) ||
+          isInfinityCost(localRE->GetCost(faceId)))
+        continue;
+      NS_LOG_INFO("Withdraw stale route " << prefix << " via " << neigh);
+      /* same as losing the neighbor (see RemoveNeighbor) */
+      localRE->SetNextHopCost(faceId, std::numeric_limits<uint32_t>::max());
+      m_routingTable.unregisterPrefix(prefix, faceId);
+      localRE->GetPathVectors().deletePath(faceId);
+      localRE->IncSeqNum(1);
+      m_routingTable.NotifyChange(prefix);
+      has_changed = true;
+    }
+  }
+  m_staleRoutes.erase(stale);
+  return has_changed;
+}
+
+void Ndvr::FlushStaleRoutes() {
+  bool has_changed = false;
+  while (!m_staleRoutes.empty()) {
+    if (DropStaleRoutes(m_staleRoutes.begin()->first, nullptr))
+      has_changed = true;
+  }
+  if (has_changed) {
+    m_routingTable.IncVersion();
+    SendHelloInterest();
+  }
+}
+
 bool Ndvr::isValidCost(uint32_t cost) {
   return cost <= std::numeric_limits<uint32_t>::max();
 }
@@ -1132,25 +1607,287 @@ bool Ndvr::isInfinityCost(uint32_t cost) {
   return cost == std::numeric_limits<uint32_t>::max();
 }
 
+/* announced by this router only (no path learned from neighbors) */
+static bool isLocalOnlyRoute(RoutingEntry &entry) {
+  return entry.isDirectRoute() && entry.GetNextHops().size() == 1;
+}
+
 void Ndvr::AdvNamePrefix(std::string name) {
-  RoutingEntry routingEntry;
+  UpdateNamePrefixes({{name, false}});
+}
+
+bool Ndvr::WithdrawNamePrefix(std::string name) {
+  return UpdateNamePrefixes({{name, true}})[0];
+}
+
+std::vector<bool>
+Ndvr::UpdateNamePrefixes(const std::vector<NamePrefixUpdate> &updates) {
+  std::vector<bool> applied;
+  applied.reserve(updates.size());
+  bool has_changed = false;
+  for (const auto &update : updates) {
+    bool changed = update.withdraw ? ApplyWithdrawal(update.name)
+                                   : ApplyAdvertisement(update.name);
+    applied.push_back(changed);
+    has_changed = has_changed || changed;
+  }
+
+  /* If the application already started (ie., there is a Hello Event), then
+   * schedule a immediate hello message to notify neighbors about a new
+   * DvInfo; otherwise, the first hello will announce them */
+  if (has_changed) {
+    UpdateAggregates();
+    m_routingTable.IncVersion();
+    if (sendhello_event) {
+      SendHelloInterest();
+    }
+  }
+  return applied;
+}
+
+void Ndvr::SetPrefixAggregation(size_t minPrefixes) {
+  m_aggregateMin = minPrefixes;
+  if (UpdateAggregates()) {
+    m_routingTable.IncVersion();
+    if (sendhello_event) {
+      SendHelloInterest();
+    }
+  }
+}
+
+bool Ndvr::ApplyAdvertisement(const std::string &name) {
+  auto localRE = m_routingTable.LookupRoute(name);
+  if (localRE != nullptr && localRE->IsAggregate()) {
+    /* configured now: stays when its aggregate is dissolved */
+    localRE->SetAggregate(false);
+    return true;
+  }
+  if (localRE != nullptr && localRE->isDirectRoute())
+    return false;
+
+  /* already learned from neighbors: keep those next hops */
+  if (localRE != nullptr) {
+    localRE->UpsertNextHop(0, 0, ""); /* directly connected */
+    localRE->SetOriginator(m_routerPrefix.toUri());
+    localRE->IncSeqNum(2);
+    m_routingTable.NotifyChange(name);
+    return true;
+  }
+
+  AddDirectRoute(name);
+  return true;
+}
+
+bool Ndvr::ApplyWithdrawal(const std::string &name) {
+  auto localRE = m_routingTable.LookupRoute(name);
+  if (localRE == nullptr || !localRE->isDirectRoute() ||
+      localRE->IsAggregate())
+    return false;
+
+  DropDirectRoute(*localRE, name);
+  return true;
+}
+
+/* name must not be in the routing table */
+RoutingEntry &Ndvr::AddDirectRoute(const std::string &name) {
+  /* advertised again after a withdrawal: supersede it */
+  uint64_t seqNum = 2;
+  auto withdrawal = m_withdrawals.find(name);
+  if (withdrawal != m_withdrawals.end()) {
+    seqNum = withdrawal->second.seqNum + 1;
+    m_withdrawals.erase(withdrawal);
+  }
+
+  /* digest is updated once, by UpdateNamePrefixes */
+  RoutingEntry &routingEntry = m_routingTable.m_rt[name];
   routingEntry.SetName(name);
-  routingEntry.SetSeqNum(1);
+  routingEntry.SetSeqNum(seqNum);
   routingEntry.UpsertNextHop(0, 0, ""); /* directly connected */
-  // routingEntry.SetFaceId(0); /* directly connected */
   routingEntry.SetOriginator(m_routerPrefix.toUri()); /* directly connected */
+  m_routingTable.NotifyChange(name);
+  return routingEntry;
+}
 
-  /* If the application already started (ie., there is a Hello Event), then
-   * update the routing table and schedule a immediate ehlo message to notify
-   * neighbors about a new DvInfo; otherwise, just insert on the initial
-   * routing table
-   * */
-  m_routingTable.insert(routingEntry);
-  m_routingTable.IncVersion();
-  if (sendhello_event) {
-    //  ResetHelloInterval();
-    SendHelloInterest();
+void Ndvr::DropDirectRoute(RoutingEntry &entry, const std::string &name) {
+  /* keep the routes learned from neighbors, if any */
+  entry.DeleteNextHop(0);
+  entry.GetPathVectors().deletePath(0);
+  entry.SetSuppressed(false);
+  if (entry.GetNextHopsSize() == 0) {
+    /* odd seqNum: newer than our announcement, older than a new one */
+    AddWithdrawal(name, entry.GetSeqNum() + 1, entry.GetOriginator());
+    m_routingTable.m_rt.erase(name);
+  }
+  m_routingTable.NotifyChange(name);
+}
+
+/* Local prefixes sharing a parent P, m_aggregateMin or more of them, are
+ * announced as P alone when that is safe (CanAggregate): P is strictly
+ * under m_network, so a router never covers the rest of its network, and
+ * no other router serves anything under P. The covered prefixes stay in
+ * the table, suppressed: announced as withdrawn so neighbors drop them,
+ * and announced again when P is dissolved (too few left, or P or a name
+ * under it is also learned from a neighbor). Evaluated when local
+ * prefixes change and when a DvInfo changes a route under P; P is not
+ * formed again before the next local change.
+ * @return true if the announced prefixes changed */
+bool Ndvr::UpdateAggregates() {
+  std::map<std::string, std::set<std::string>> wanted;
+  if (m_aggregateMin > 0) {
+    for (auto &route : m_routingTable) {
+      if (route.second.IsAggregate() || !isLocalOnlyRoute(route.second))
+        continue;
+      Name name(route.first);
+      if (name.size() < m_network.size() + 2 || !m_network.isPrefixOf(name))
+        continue;
+      wanted[name.getPrefix(-1).toUri()].insert(route.first);
+    }
+    for (auto it = wanted.begin(); it != wanted.end();) {
+      if (it->second.size() < m_aggregateMin || !CanAggregate(it->first))
+        it = wanted.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  bool has_changed = false;
+  for (const auto &aggregate : m_aggregates) {
+    auto members = wanted.find(aggregate.first);
+    for (const auto &name : aggregate.second) {
+      if (members != wanted.end() && members->second.count(name) != 0)
+        continue;
+      auto entry = m_routingTable.LookupRoute(name);
+      if (entry != nullptr && entry->IsSuppressed()) {
+        SetSuppressed(*entry, name, false);
+        has_changed = true;
+      }
+    }
+    if (members != wanted.end())
+      continue;
+    auto entry = m_routingTable.LookupRoute(aggregate.first);
+    if (entry != nullptr && entry->IsAggregate()) {
+      entry->SetAggregate(false);
+      DropDirectRoute(*entry, aggregate.first);
+    }
+    has_changed = true;
+  }
+
+  for (const auto &aggregate : wanted) {
+    if (m_routingTable.LookupRoute(aggregate.first) == nullptr) {
+      AddDirectRoute(aggregate.first).SetAggregate(true);
+      has_changed = true;
+    }
+    for (const auto &name : aggregate.second) {
+      auto entry = m_routingTable.LookupRoute(name);
+      if (!entry->IsSuppressed()) {
+        SetSuppressed(*entry, name, true);
+        has_changed = true;
+      }
+    }
+  }
+  m_aggregates.swap(wanted);
+  return has_changed;
+}
+
+bool Ndvr::IsUnderAggregate(const std::string &name) const {
+  if (m_aggregates.empty())
+    return false;
+  Name prefix(name);
+  for (size_t len = m_network.size() + 1; len <= prefix.size(); ++len) {
+    if (m_aggregates.count(prefix.getPrefix(len).toUri()) != 0)
+      return true;
+  }
+  return false;
+}
+
+/* prefix is ours to announce: not a route of its own (unless our
+ * aggregate), and whatever is under it is local only */
+bool Ndvr::CanAggregate(const std::string &prefix) {
+  auto covering = m_routingTable.LookupRoute(prefix);
+  if (covering != nullptr && !covering->IsAggregate())
+    return false;
+  auto range = m_routingTable.m_rt.subtree(prefix);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (&it->second != covering && !isLocalOnlyRoute(it->second))
+      return false;
   }
+  return true;
+}
+
+void Ndvr::SetSuppressed(RoutingEntry &entry, const std::string &name,
+                         bool suppressed) {
+  entry.SetSuppressed(suppressed);
+  if (suppressed) {
+    /* neighbors drop it as if withdrawn */
+    AddWithdrawal(name, entry.GetSeqNum() + 1, entry.GetOriginator());
+    return;
+  }
+  /* announced again: supersede the withdrawal (or what neighbors
+   * remember of it) */
+  auto withdrawal = m_withdrawals.find(name);
+  if (withdrawal != m_withdrawals.end()) {
+    entry.SetSeqNum(
+        std::max(entry.GetSeqNum() + 2, withdrawal->second.seqNum + 1));
+    m_withdrawals.erase(withdrawal);
+  } else {
+    entry.IncSeqNum(2);
+  }
+}
+
+void Ndvr::AddWithdrawal(const std::string &name, uint64_t seqNum,
+                         const std::string &originator) {
+  auto &withdrawal = m_withdrawals[name];
+  withdrawal.seqNum = std::max(withdrawal.seqNum, seqNum);
+  withdrawal.originator = originator;
+  withdrawal.expiry = time::steady_clock::now() + kWithdrawalHoldTime;
+  if (!expirewithdrawals_event)
+    expirewithdrawals_event = m_scheduler.schedule(
+        kWithdrawalHoldTime, [this] { ExpireWithdrawals(); });
+}
+
+void Ndvr::ExpireWithdrawals() {
+  auto now = time::steady_clock::now();
+  auto next = time::steady_clock::TimePoint::max();
+  for (auto it = m_withdrawals.begin(); it != m_withdrawals.end();) {
+    if (it->second.expiry <= now) {
+      it = m_withdrawals.erase(it);
+    } else {
+      next = std::min(next, it->second.expiry);
+      ++it;
+    }
+  }
+  if (!m_withdrawals.empty())
+    expirewithdrawals_event =
+        m_scheduler.schedule(next - now, [this] { ExpireWithdrawals(); });
+}
+
+void Ndvr::RecordPrefixFlap(const std::string &prefix) {
+  if (m_prefixDamping.addFlap(prefix)) {
+    NS_LOG_INFO("Prefix " << prefix << " is flapping, suppressed for "
+                          << m_prefixDamping.getReuseDelay(prefix));
+  }
+  /* no flap in the last half-life is needed to forget the penalties, so
+   * check at least that often while there are some */
+  if (!dampingreuse_event && !m_prefixDamping.empty())
+    dampingreuse_event = m_scheduler.schedule(
+        m_prefixDamping.getParams().halfLife, [this] { ReuseDampedPrefixes(); });
+}
+
+void Ndvr::ReuseDampedPrefixes() {
+  if (!m_prefixDamping.expire().empty()) {
+    /* their announcements were ignored meanwhile: the next Hello of each
+     * neighbor fetches its DvInfo again */
+    for (auto &neigh : m_neighMap)
+      neigh.second.SetVersion(0);
+  }
+  if (m_prefixDamping.empty())
+    return;
+  auto now = time::steady_clock::now();
+  auto next = std::min(m_prefixDamping.getNextReuse(),
+                       now + m_prefixDamping.getParams().halfLife);
+  dampingreuse_event = m_scheduler.schedule(
+      std::max(next - now, time::steady_clock::duration::zero()),
+      [this] { ReuseDampedPrefixes(); });
 }
 
 uint64_t Ndvr::CreateUnicastFace(std::string mac) {
@@ -6,8 +6,10 @@
 #include <iostream>
 #include <map>
 #include <random>
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 // #include <ns3/core-module.h>
 #include <ndn-cxx/face.hpp>
@@ -20,9 +22,16 @@
 #include <ndn-cxx/util/scheduler.hpp>
 #include <ndn-cxx/util/time.hpp>
 
+#include "certificate-store.hpp"
+#include "crypto-worker-pool.hpp"
+#include "dvinfo-signer.hpp"
+#include "duplicate-filter.hpp"
+#include "flap-damping.hpp"
 #include "ndvr-message-helper.hpp"
 #include "ndvr-message.pb.h"
+#include "routing-snapshot.hpp"
 #include "routing-table.hpp"
+#include "validation-cache.hpp"
 
 namespace ndn {
 namespace ndvr {
@@ -31,6 +40,22 @@ static const Name kNdvrPrefix = Name("/localhop/ndvr");
 static const Name kNdvrHelloPrefix = Name("/localhop/ndvr/dvannc");
 static const Name kNdvrDvInfoPrefix = Name("/localhop/ndvr/dvinfo");
 static const std::string kRouterTag = "%C1.Router";
+static const time::seconds kCertStoreReloadInterval = time::seconds(60);
+static const time::seconds kCertStoreMinReloadInterval = time::seconds(1);
+/* certificates retained per validated DvInfo: key, then its issuers */
+static const int kMaxRetainedChainDepth = 4;
+/* snapshots older than this are ignored at start-up */
+static const time::seconds kSnapshotMaxAge = time::seconds(600);
+/* restored routes not refreshed by their neighbor by then are withdrawn */
+static const time::seconds kStaleRouteTimeout = time::seconds(30);
+/* withdrawn prefixes are announced (infinite cost) for this long */
+static const time::seconds kWithdrawalHoldTime = time::seconds(30);
+
+/* one step of Ndvr::UpdateNamePrefixes */
+struct NamePrefixUpdate {
+  std::string name;
+  bool withdraw;
+};
 
 class NeighborEntry {
 public:
@@ -50,6 +75,12 @@ public:
 
   void SetFaceId(uint64_t faceId) { m_faceId = faceId; }
   uint64_t GetFaceId() { return m_faceId; }
+
+  /* version of the last DvInfo applied from this neighbor (the version
+   * above is the one announced, possibly not fetched yet) */
+  void SetDvInfoVersion(uint64_t ver) { m_dvInfoVersion = ver; }
+  uint64_t GetDvInfoVersion() { return m_dvInfoVersion; }
+
   void UpdateLastSeen() { m_lastSeen = time::steady_clock::now(); }
   time::seconds GetLastSeenDelta() {
     return time::duration_cast<time::seconds>(time::steady_clock::now() -
@@ -68,6 +99,7 @@ private:
   std::string m_name;
   uint64_t m_faceId;
   uint64_t m_version;
+  uint64_t m_dvInfoVersion = 0;
   time::steady_clock::TimePoint m_lastSeen;
   time::seconds m_helloTimeout;
   // TODO: key
@@ -84,7 +116,10 @@ private:
 
 class Ndvr {
 public:
-  Ndvr(const ndn::security::SigningInfo &signingInfo, Name network,
+  typedef std::map<std::string, NeighborEntry> NeighborMap;
+
+  Ndvr(ndn::Face &face, ndn::KeyChain &keyChain,
+       const ndn::security::SigningInfo &signingInfo, Name network,
        Name routerName, std::vector<std::string> &np,
        std::vector<std::string> &faces, std::vector<std::string> &monitorFaces,
        std::string validationConfig);
@@ -93,6 +128,19 @@ public:
   void Start();
   void Stop();
   void AdvNamePrefix(std::string name);
+  /** @brief stop announcing a local name prefix
+   * @return false if name is not a local prefix */
+  bool WithdrawNamePrefix(std::string name);
+  /** @brief advertise and withdraw local name prefixes, in order, as a
+   * single change: one version bump (and digest update) and one hello
+   * @return for each update, whether it changed the routing table
+   * (false for a withdrawal of a prefix that is not local) */
+  std::vector<bool>
+  UpdateNamePrefixes(const std::vector<NamePrefixUpdate> &updates);
+  /** @brief announce a covering prefix instead of the local prefixes it
+   * covers, once minPrefixes of them share it as parent (0: disabled);
+   * see UpdateAggregates for when it is done */
+  void SetPrefixAggregation(size_t minPrefixes);
 
   const ndn::Name &getRouterPrefix() const { return m_routerPrefix; }
 
@@ -100,12 +148,64 @@ public:
 
   void SetHelloInterval(int x) { m_helloIntervalCur = x; }
 
-private:
-  typedef std::map<std::string, NeighborEntry> NeighborMap;
+  RoutingManager &getRoutingTable() { return m_routingTable; }
+
+  /** @brief Damp neighbors that keep disappearing (a suppressed neighbor's
+   * Hellos are ignored) and prefixes that keep becoming unreachable (a
+   * suppressed prefix is not learned again), so that they stop causing
+   * updates network-wide. A flapPenalty of 0 disables it. */
+  void SetFlapDamping(const FlapDamping::Params &params) {
+    m_neighborDamping.setParams(params);
+    m_prefixDamping.setParams(params);
+  }
+
+  FlapDamping &getNeighborDamping() { return m_neighborDamping; }
+
+  FlapDamping &getPrefixDamping() { return m_prefixDamping; }
 
+  NeighborMap &getNeighbors() { return m_neighMap; }
+
+  /** @brief true if the route to prefix through neigh was restored from
+   * a snapshot and not refreshed yet */
+  bool IsStaleNextHop(const std::string &neigh,
+                      const std::string &prefix) const {
+    auto it = m_staleRoutes.find(neigh);
+    return it != m_staleRoutes.end() && it->second.count(prefix) != 0;
+  }
+
+  void SetDvInfoSigner(std::unique_ptr<DvInfoSigner> signer) {
+    m_dvInfoSigner = std::move(signer);
+  }
+
+  /** @brief Run DvInfo signing/verification and decoding on pool
+   * (nullptr: inline).
+   * The DvInfo signer must then be thread-safe and not share its
+   * KeyChain with this instance. */
+  void SetCryptoWorkerPool(CryptoWorkerPool *pool) { m_cryptoPool = pool; }
+
+  /** @brief Share the retained neighbor certificates with other
+   * instances running on the same event loop. Only certificates of a
+   * chain one of them validated are retained, and each instance's
+   * validator still verifies what it takes from the store, so the
+   * instances must load the same trust rules. */
+  void SetRetainedCertificates(std::shared_ptr<RetainedCertificates> certs) {
+    m_certFetcher->setStore(std::move(certs));
+  }
+
+  /** @brief Persist the routing state to path every interval and on
+   * Stop(), and restore it (routes stale until refreshed) on Start() */
+  void SetSnapshotFile(const std::string &path,
+                       time::seconds interval = time::seconds(10)) {
+    m_snapshotFile = path;
+    m_snapshotInterval = interval;
+  }
+
+private:
   void processInterest(const ndn::Interest &interest);
   void OnHelloInterest(const ndn::Interest &interest, uint64_t inFaceId);
   void OnKeyInterest(const ndn::Interest &interest);
+  bool isOwnKeyName(const Name &name) const;
+  void ReloadCertificates();
   void OnDvInfoInterest(const ndn::Interest &interest);
   void ReplyDvInfoInterest(const ndn::Interest &interest);
   void OnDvInfoContent(const ndn::Interest &interest, const ndn::Data &data);
@@ -114,9 +214,13 @@ private:
   void SchedDvInfoInterest(NeighborEntry &neighbor, bool wait = false,
                            uint32_t retx = 0);
   void SendDvInfoInterest(const std::string &neighbor_name, uint32_t retx = 0);
-  void OnValidatedDvInfo(const ndn::Data &data);
+  void OnValidatedDvInfo(const ndn::Data &data, uint64_t seq);
   void OnDvInfoValidationFailed(const ndn::Data &data,
-                                const ndn::security::v2::ValidationError &ve);
+                                const ndn::security::v2::ValidationError &ve,
+                                uint64_t seq);
+  void RememberVerifiedKey(const ndn::Data &data);
+  std::unique_ptr<security::v2::CertificateFetcher> makeCertificateFetcher();
+  void runOnWorker(std::function<void()> job, std::function<void()> done);
   void SendHelloInterest();
   void registerPrefixes();
   void registerNeighborPrefix(NeighborEntry &neighbor, uint64_t oldFaceId,
@@ -125,7 +229,13 @@ private:
   bool isValidCost(uint32_t cost);
   void EncodeDvInfo(std::string &out);
   void processDvInfoFromNeighbor(NeighborEntry &neighbor,
-                                 RoutingTable &dvinfo_other);
+                                 RoutingTable &dvinfo_other,
+                                 uint64_t decodedFaceId = 0);
+  static std::shared_ptr<RoutingTable>
+  PrepareDvInfo(const ndn::Block &content, uint64_t faceId,
+                const std::string &routerPrefix_Uri);
+  void DiscardPendingDvInfo(uint64_t seq);
+  void ApplyPendingDvInfo();
   void IncreaseHelloInterval();
   void ResetHelloInterval();
   uint64_t ExtractIncomingFace(const ndn::Interest &interest);
@@ -136,6 +246,24 @@ private:
   uint64_t CreateUnicastFace(std::string mac);
   std::string GetNeighborToken();
   void UpdateRoutingTableDigest();
+  void SaveSnapshot();
+  void LoadSnapshot();
+  bool DropStaleRoutes(const std::string &neigh, const RoutingTable *keep);
+  void FlushStaleRoutes();
+  bool ApplyAdvertisement(const std::string &name);
+  bool ApplyWithdrawal(const std::string &name);
+  RoutingEntry &AddDirectRoute(const std::string &name);
+  void DropDirectRoute(RoutingEntry &entry, const std::string &name);
+  bool UpdateAggregates();
+  bool CanAggregate(const std::string &prefix);
+  bool IsUnderAggregate(const std::string &name) const;
+  void SetSuppressed(RoutingEntry &entry, const std::string &name,
+                     bool suppressed);
+  void AddWithdrawal(const std::string &name, uint64_t seqNum,
+                     const std::string &originator);
+  void ExpireWithdrawals();
+  void RecordPrefixFlap(const std::string &prefix);
+  void ReuseDampedPrefixes();
   void onFaceEventNotification(
       const ndn::nfd::FaceEventNotification &faceEventNotification);
 
@@ -214,9 +342,20 @@ private:
 
 private:
   const ndn::security::SigningInfo &m_signingInfo;
-  ndn::Face m_face;
+  /* m_face and m_keyChain are owned by whoever runs this instance
+   * (NdvrRunner, NdvrApp or the ndvr-emu harness), so that several
+   * instances can share one io_service and one key chain */
+  ndn::Face &m_face;
+  ndn::KeyChain &m_keyChain;
   ndn::Scheduler m_scheduler;
+  /* owned by m_validator */
+  RetainingCertificateFetcher *m_certFetcher = nullptr;
   ndn::ValidatorConfig m_validator;
+  ValidationCache m_validationCache;
+  VerifiedKeyCache m_verifiedKeys;
+  /* this router's certificates, served to neighbors (OnKeyInterest) */
+  CertificateStore m_certStore;
+  time::steady_clock::TimePoint m_certStoreLoadTime;
   uint32_t m_seq;
   // std::uniform_int_distribution<int>
   // m_rand_nonce(0,std::numeric_limits<int>::max());
@@ -228,7 +367,6 @@ private:
   std::vector<std::string> m_listenFaces;
   std::vector<std::string> m_facesToBeMonitored;
 
-  ndn::KeyChain m_keyChain;
   Name m_routerPrefix;
   NeighborMap m_neighMap;
   std::map<std::string, uint64_t> m_neighToFaceId;
@@ -261,6 +399,11 @@ private:
       increasehellointerval_event; /* increase hello interval event scheduler */
   scheduler::EventId
       replydvinfo_event; /* group dvinfo replies to avoid duplicate */
+  scheduler::EventId reloadcerts_event; /* refresh m_certStore */
+  scheduler::EventId savesnapshot_event; /* periodic SaveSnapshot */
+  scheduler::EventId flushstale_event;   /* withdraw stale routes */
+  scheduler::EventId expirewithdrawals_event; /* forget m_withdrawals */
+  scheduler::EventId dampingreuse_event; /* ReuseDampedPrefixes */
   std::random_device rdevice_;
   std::mt19937 m_rengine;
   std::uniform_int_distribution<> replydvinfo_dist =
@@ -278,6 +421,62 @@ private:
   /* m_faceMonitor - monitor /localhost/nfd/faces/events through nfd
    * API - which leverage CallBacks to make NDVR aware of events */
   ndn::nfd::FaceMonitor m_faceMonitor;
+
+  /* m_dvInfoSigner - signing scheme of DvInfo replies (router's key by
+   * default, see SetDvInfoSigner); shared with in-flight crypto jobs */
+  std::shared_ptr<DvInfoSigner> m_dvInfoSigner;
+
+  /* m_cryptoPool - where signing/verification and DvInfo decoding run
+   * (nullptr: inline, e.g., under ndnSIM); m_cryptoGuard drops
+   * completions that arrive after this instance is destroyed */
+  CryptoWorkerPool *m_cryptoPool = nullptr;
+  std::shared_ptr<int> m_cryptoGuard = std::make_shared<int>(0);
+
+  /* DvInfo numbered on arrival (m_dvInfoSeqNext), validated and
+   * decoded, waiting to be applied in arrival order (m_dvInfoSeqApply is
+   * the next one to apply); a DvInfo that failed validation is
+   * discarded, so as not to hold back the following ones */
+  struct PendingDvInfo {
+    bool discarded = false;
+    std::string neighPrefix;
+    uint64_t faceId = 0;
+    uint64_t version = 0;
+    std::shared_ptr<RoutingTable> rt;
+  };
+  std::map<uint64_t, PendingDvInfo> m_dvInfoPending;
+  uint64_t m_dvInfoSeqNext = 0;
+  uint64_t m_dvInfoSeqApply = 0;
+
+  /* Warm restart (see RoutingSnapshot): m_lastSnapshot is what is on
+   * disk, to skip rewriting an unchanged state. m_staleRoutes holds, per
+   * neighbor, the prefixes restored through it that the neighbor has not
+   * confirmed yet (same DvInfo version in a Hello, or a new DvInfo) */
+  std::string m_snapshotFile;
+  time::seconds m_snapshotInterval = time::seconds(10);
+  std::string m_lastSnapshot;
+  std::map<std::string, std::set<std::string>> m_staleRoutes;
+
+  /* Prefixes withdrawn here or by neighbors, announced in the DvInfo with
+   * an infinite cost until expiry (kWithdrawalHoldTime), so neighbors drop
+   * them at once and announcements older than seqNum are ignored */
+  struct Withdrawal {
+    uint64_t seqNum = 0;
+    std::string originator;
+    time::steady_clock::TimePoint expiry;
+  };
+  std::map<std::string, Withdrawal> m_withdrawals;
+
+  /* Prefix aggregation (see UpdateAggregates): covering prefix announced
+   * => local prefixes it suppresses */
+  size_t m_aggregateMin = 0;
+  std::map<std::string, std::set<std::string>> m_aggregates;
+
+  /* Flap damping, see SetFlapDamping */
+  FlapDamping m_neighborDamping;
+  FlapDamping m_prefixDamping;
+
+  /* Hellos and DvInfo Interests received again over another path */
+  DuplicateFilter m_duplicateFilter;
 };
 
 } // namespace ndvr
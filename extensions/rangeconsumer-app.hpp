@@ -30,14 +30,19 @@ public:
                     MakeIntegerAccessor(&RangeConsumerApp::last_), MakeIntegerChecker<uint32_t>())
       .AddAttribute("Frequency", "Frequency to send interest",
                     IntegerValue(0),
-                    MakeIntegerAccessor(&RangeConsumerApp::frequency_), MakeIntegerChecker<uint32_t>());
+                    MakeIntegerAccessor(&RangeConsumerApp::frequency_), MakeIntegerChecker<uint32_t>())
+      .AddAttribute("CongestionControl",
+                    "none: Frequency Interests per second and prefix; aimd: congestion window per prefix",
+                    StringValue("none"),
+                    MakeStringAccessor(&RangeConsumerApp::congestionControl_), MakeStringChecker());
 
     return tid;
   }
 
 protected:
   virtual void StartApplication() {
-    m_instance.reset(new ::ndn::ndvr::RangeConsumer(prefix_, first_, last_, frequency_));
+    m_instance.reset(new ::ndn::ndvr::RangeConsumer(prefix_, first_, last_, frequency_,
+                                                    congestionControl_));
     m_instance->Start();
   }
 
@@ -52,6 +57,7 @@ private:
   uint32_t first_;
   uint32_t last_;
   uint32_t frequency_;
+  std::string congestionControl_;
 };
 
 } // namespace ns3
@@ -22,7 +22,10 @@ NS_LOG_COMPONENT_DEFINE("ndn.RangeConsumer");
 namespace ndn {
 namespace ndvr {
 
-RangeConsumer::RangeConsumer(std::string prefix, uint32_t first, uint32_t last, uint32_t frequency)
+const uint32_t RangeConsumer::kMaxRetries;
+
+RangeConsumer::RangeConsumer(std::string prefix, uint32_t first, uint32_t last, uint32_t frequency,
+                             const std::string& congestionControl)
   : m_scheduler(m_face.getIoService())
   , m_validator(m_face)
   , m_rengine(rdevice_())
@@ -31,20 +34,33 @@ RangeConsumer::RangeConsumer(std::string prefix, uint32_t first, uint32_t last,
   , m_first(first)
   , m_last(last)
   , m_frequency(frequency)
+  , m_congestionControl(congestionControl == "aimd")
 {
+  if (congestionControl != "none" && congestionControl != "aimd")
+    throw Error("Unknown congestion control " + congestionControl + " (none or aimd)");
+
   ns3::Ptr<ns3::Node> thisNode = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
   m_nodeid = thisNode->GetId();
 }
 
 void RangeConsumer::Start() {
+  m_startTime = time::steady_clock::now();
   for(uint32_t i = m_first; i <= m_last; i++) {
     Name namePrefix(m_prefix);
     namePrefix.appendNumber(i);
+    if (m_congestionControl) {
+      m_flows.emplace_back(namePrefix.toUri());
+      continue;
+    }
     RequestSyncData(namePrefix.toUri());
   }
+  for (size_t flowId = 0; flowId < m_flows.size(); flowId++)
+    FillWindow(flowId);
 }
 
 void RangeConsumer::Stop() {
+  if (m_congestionControl)
+    PrintFlowStats();
 }
 
 void RangeConsumer::run() {
@@ -86,6 +102,163 @@ void RangeConsumer::OnSyncDataContent(const ndn::Interest& interest, const ndn::
   NS_LOG_DEBUG("Received content for SynData: size=" << data.getContent().value_size() << " name=" << data.getName());
 }
 
+void RangeConsumer::FillWindow(size_t flowId) {
+  Flow& flow = m_flows[flowId];
+  while (flow.nInFlight < std::max<size_t>(1, static_cast<size_t>(flow.cwnd))) {
+    uint32_t seq;
+    if (!flow.retxQueue.empty()) {
+      seq = flow.retxQueue.front();
+      flow.retxQueue.pop_front();
+    }
+    else {
+      seq = flow.nextSeq++;
+    }
+    SendFlowInterest(flowId, seq);
+  }
+}
+
+void RangeConsumer::SendFlowInterest(size_t flowId, uint32_t seq) {
+  Flow& flow = m_flows[flowId];
+  auto now = time::steady_clock::now();
+  auto inserted = flow.pending.emplace(seq, Pending());
+  Pending& pending = inserted.first->second;
+  if (inserted.second) {
+    pending.firstSent = now;
+  }
+  else {
+    pending.nRetx++;
+    flow.nRetx++;
+  }
+  pending.lastSent = now;
+  flow.nInFlight++;
+
+  Name n = Name(flow.name);
+  n.appendSequenceNumber(seq);
+  Interest interest = Interest(n);
+  interest.setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest.setCanBePrefix(false);
+  interest.setInterestLifetime(time::duration_cast<time::milliseconds>(flow.rtt.getEstimatedRto()));
+  NS_LOG_DEBUG("Sending Data interest i.name=" << n << " cwnd=" << flow.cwnd
+               << " retx=" << pending.nRetx);
+
+  m_face.expressInterest(interest,
+    [this, flowId, seq] (const Interest&, const Data& data) { OnFlowData(flowId, seq, data); },
+    [this, flowId, seq] (const Interest&, const lp::Nack& nack) { OnFlowNack(flowId, seq, nack); },
+    [this, flowId, seq] (const Interest&) { OnFlowTimedOut(flowId, seq); });
+}
+
+void RangeConsumer::OnFlowData(size_t flowId, uint32_t seq, const ndn::Data& data) {
+  Flow& flow = m_flows[flowId];
+  auto it = flow.pending.find(seq);
+  if (it == flow.pending.end())
+    return;
+
+  auto now = time::steady_clock::now();
+  /* Karn: the RTT of a retransmitted Interest is ambiguous */
+  if (it->second.nRetx == 0)
+    flow.rtt.addMeasurement(now - it->second.lastSent, std::max<size_t>(1, flow.nInFlight));
+  flow.latencySum += now - it->second.firstSent;
+  flow.nData++;
+  flow.nBytes += data.getContent().value_size();
+  flow.pending.erase(it);
+  flow.nInFlight--;
+
+  if (data.getCongestionMark() > 0) {
+    NS_LOG_DEBUG("Congestion mark on " << data.getName());
+    flow.nMarks++;
+    DecreaseWindow(flow);
+  }
+  else {
+    IncreaseWindow(flow);
+  }
+  FillWindow(flowId);
+}
+
+void RangeConsumer::OnFlowTimedOut(size_t flowId, uint32_t seq) {
+  Flow& flow = m_flows[flowId];
+  NS_LOG_DEBUG("Interest timed out for Name: " << flow.name << " seq=" << seq);
+  flow.nTimeouts++;
+  flow.nInFlight--;
+  flow.rtt.backoffRto();
+  DecreaseWindow(flow);
+  RetransmitLater(flow, seq);
+  FillWindow(flowId);
+}
+
+void RangeConsumer::OnFlowNack(size_t flowId, uint32_t seq, const ndn::lp::Nack& nack) {
+  Flow& flow = m_flows[flowId];
+  NS_LOG_DEBUG("Received Nack for " << flow.name << " seq=" << seq << " with reason: " << nack.getReason());
+  flow.nNacks++;
+  if (nack.getReason() == lp::NackReason::CONGESTION)
+    DecreaseWindow(flow);
+  else
+    flow.rtt.backoffRto();
+
+  /* the path may be back (e.g. NO_ROUTE while routing converges) after an
+   * RTO; until then seq still takes its place in the window, otherwise a
+   * local Nack (no delay) would have the window refilled, and Nacked, in
+   * a loop */
+  m_scheduler.schedule(flow.rtt.getEstimatedRto(), [this, flowId, seq] {
+    Flow& flow = m_flows[flowId];
+    flow.nInFlight--;
+    RetransmitLater(flow, seq);
+    FillWindow(flowId);
+  });
+}
+
+void RangeConsumer::RetransmitLater(Flow& flow, uint32_t seq) {
+  auto it = flow.pending.find(seq);
+  if (it == flow.pending.end())
+    return;
+  if (it->second.nRetx >= kMaxRetries) {
+    NS_LOG_DEBUG("Giving up on " << flow.name << " seq=" << seq);
+    flow.nLost++;
+    flow.pending.erase(it);
+    return;
+  }
+  flow.retxQueue.push_back(seq);
+}
+
+void RangeConsumer::IncreaseWindow(Flow& flow) {
+  if (flow.cwnd < flow.ssthresh)
+    flow.cwnd += 1;
+  else
+    flow.cwnd += 1 / flow.cwnd;
+}
+
+void RangeConsumer::DecreaseWindow(Flow& flow) {
+  /* one decrease per RTT: the losses of a window have a single cause */
+  auto now = time::steady_clock::now();
+  if (flow.lastDecrease != time::steady_clock::TimePoint() &&
+      now - flow.lastDecrease < flow.rtt.getSmoothedRtt())
+    return;
+  flow.ssthresh = std::max(2.0, flow.cwnd / 2);
+  flow.cwnd = flow.ssthresh;
+  flow.lastDecrease = now;
+}
+
+void RangeConsumer::PrintFlowStats() const {
+  double seconds = time::duration_cast<time::microseconds>(time::steady_clock::now() - m_startTime).count() / 1e6;
+  for (const auto& flow : m_flows) {
+    double avgLatency = flow.nData > 0 ?
+      time::duration_cast<time::microseconds>(flow.latencySum).count() / 1e3 / flow.nData : 0;
+    std::cout << "RangeConsumer node=" << m_nodeid
+              << " prefix=" << flow.name
+              << " data=" << flow.nData
+              << " timeouts=" << flow.nTimeouts
+              << " nacks=" << flow.nNacks
+              << " marks=" << flow.nMarks
+              << " retx=" << flow.nRetx
+              << " lost=" << flow.nLost
+              << " throughput_kbps=" << (seconds > 0 ? flow.nBytes * 8 / seconds / 1e3 : 0)
+              << " rtt_min_ms=" << (flow.nData > 0 ? flow.rtt.getMinRtt().count() / 1e6 : 0)
+              << " rtt_avg_ms=" << (flow.nData > 0 ? flow.rtt.getAvgRtt().count() / 1e6 : 0)
+              << " rtt_max_ms=" << (flow.nData > 0 ? flow.rtt.getMaxRtt().count() / 1e6 : 0)
+              << " latency_avg_ms=" << avgLatency
+              << " cwnd=" << flow.cwnd << std::endl;
+  }
+}
+
 
 } // namespace ndvr
 } // namespace ndn
@@ -4,16 +4,21 @@
 #define RANGECONSUMER_HPP
 
 
+#include <deque>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <unordered_set>
 #include <string>
 #include <random>
+#include <vector>
 
 #include <ndn-cxx/face.hpp>
 #include <ndn-cxx/interest.hpp>
 #include <ndn-cxx/security/key-chain.hpp>
 #include <ndn-cxx/security/signing-helpers.hpp>
 #include <ndn-cxx/security/validator-config.hpp>
+#include <ndn-cxx/util/rtt-estimator.hpp>
 #include <ndn-cxx/util/scheduler.hpp>
 #include <ndn-cxx/util/time.hpp>
 #include <ns3/core-module.h>
@@ -30,10 +35,23 @@ private:
   std::string what_;
 };
 
+/**
+ * Fetches <prefix>/<i>/<seq> for every i in [first, last], seq = 0, 1, ...
+ *
+ * With congestion control "none", each prefix is requested at a fixed
+ * frequency (Interests per second), whatever happens to them. With "aimd",
+ * each prefix is a flow with its own congestion window: slow start, then
+ * one more Interest in flight per RTT, and the window halved (at most once
+ * per RTT) on a timeout, a congestion Nack or a congestion-marked Data.
+ * Interest lifetimes follow the RTO of an RttEstimator; lost sequence
+ * numbers are retransmitted (up to kMaxRetries times), and throughput,
+ * RTT and latency statistics of every flow are printed on Stop().
+ */
 class RangeConsumer
 {
 public:
-  RangeConsumer(std::string prefix, uint32_t first, uint32_t last, uint32_t frequency);
+  RangeConsumer(std::string prefix, uint32_t first, uint32_t last, uint32_t frequency,
+                const std::string& congestionControl = "none");
   void run();
   void Start();
   void Stop();
@@ -44,6 +62,51 @@ private:
   void OnSyncDataNack(const ndn::Interest& interest, const ndn::lp::Nack& nack);
   void OnSyncDataContent(const ndn::Interest& interest, const ndn::Data& data);
 
+  /* congestion controlled flows */
+  struct Pending
+  {
+    time::steady_clock::TimePoint firstSent;
+    time::steady_clock::TimePoint lastSent;
+    uint32_t nRetx = 0;
+  };
+
+  struct Flow
+  {
+    explicit Flow(const std::string& name) : name(name) {}
+
+    std::string name;
+    double cwnd = 1;
+    double ssthresh = std::numeric_limits<double>::max();
+    time::steady_clock::TimePoint lastDecrease;
+    ndn::util::RttEstimatorWithStats rtt;
+
+    uint32_t nextSeq = 0;
+    std::map<uint32_t, Pending> pending;  // sent and not answered yet
+    std::deque<uint32_t> retxQueue;
+    size_t nInFlight = 0;
+
+    /* statistics */
+    uint64_t nData = 0;
+    uint64_t nBytes = 0;
+    uint64_t nTimeouts = 0;
+    uint64_t nNacks = 0;
+    uint64_t nMarks = 0;
+    uint64_t nRetx = 0;
+    uint64_t nLost = 0;
+    time::nanoseconds latencySum = time::nanoseconds::zero();
+  };
+
+  void FillWindow(size_t flowId);
+  void SendFlowInterest(size_t flowId, uint32_t seq);
+  void OnFlowData(size_t flowId, uint32_t seq, const ndn::Data& data);
+  void OnFlowTimedOut(size_t flowId, uint32_t seq);
+  void OnFlowNack(size_t flowId, uint32_t seq, const ndn::lp::Nack& nack);
+  /* queue seq for retransmission, or count it lost after kMaxRetries */
+  void RetransmitLater(Flow& flow, uint32_t seq);
+  void IncreaseWindow(Flow& flow);
+  void DecreaseWindow(Flow& flow);
+  void PrintFlowStats() const;
+
 private:
   ndn::Scheduler m_scheduler;
   ndn::Face m_face;
@@ -59,6 +122,11 @@ private:
   uint32_t m_first;
   uint32_t m_last;
   uint32_t m_frequency;
+
+  bool m_congestionControl;
+  std::vector<Flow> m_flows;
+  time::steady_clock::TimePoint m_startTime;
+  static const uint32_t kMaxRetries = 3;
 };
 
 } // namespace ndvr
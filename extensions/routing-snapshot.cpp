@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "routing-snapshot.hpp"
+#include "ndvr-message.pb.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ndn-cxx/util/sha256.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+namespace {
+
+const std::string kSnapshotMagic = "NDVRSNP1";
+const size_t kSnapshotDigestSize = 32;
+
+ConstBufferPtr computeDigest(const char *buf, size_t size) {
+  return util::Sha256::computeDigest(reinterpret_cast<const uint8_t *>(buf),
+                                     size);
+}
+
+bool writeAll(int fd, const std::string &data) {
+  const char *buf = data.data();
+  size_t left = data.size();
+  while (left > 0) {
+    ssize_t n = ::write(fd, buf, left);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    buf += n;
+    left -= n;
+  }
+  return true;
+}
+
+} // namespace
+
+void RoutingSnapshot::encode(std::string &out, const std::string &routerPrefix,
+                             RoutingManager &rm,
+                             const std::vector<Neighbor> &neighbors) {
+  proto::RoutingSnapshot snap;
+  std::unordered_map<std::string, uint32_t> routerIndex;
+  auto intern = [&snap, &routerIndex](const std::string &name) {
+    auto it = routerIndex.find(name);
+    if (it != routerIndex.end())
+      return it->second;
+    uint32_t i = snap.router_size();
+    snap.add_router(name);
+    routerIndex.emplace(name, i);
+    return i;
+  };
+  intern("");
+
+  snap.set_router_prefix(routerPrefix);
+  snap.set_version(rm.GetVersion());
+  for (auto &item : rm) {
+    auto &entry = item.second;
+    auto *route = snap.add_route();
+    route->set_prefix(item.first);
+    route->set_seq(entry.GetSeqNum());
+    route->set_originator(intern(entry.GetOriginator()));
+    for (const auto &nh : entry.GetNextHops()) {
+      auto *nextHop = route->add_next_hop();
+      nextHop->set_face_id(nh.faceId);
+      nextHop->set_cost(nh.cost);
+      nextHop->set_neighbor(intern(nh.neighName));
+    }
+    for (const auto &facePaths : entry.GetPathVectors()) {
+      for (const auto &nextHop : facePaths.second) {
+        auto *path = route->add_path();
+        path->set_face_id(facePaths.first);
+        for (const auto &routerId : nextHop.GetRouterIds())
+          path->add_hop(intern(routerId));
+      }
+    }
+  }
+  for (const auto &neighbor : neighbors) {
+    auto *n = snap.add_neighbor();
+    n->set_name(intern(neighbor.name));
+    n->set_face_id(neighbor.faceId);
+    n->set_version(neighbor.version);
+  }
+
+  std::string payload;
+  snap.SerializeToString(&payload);
+  auto digest = computeDigest(payload.data(), payload.size());
+
+  out.clear();
+  out.reserve(kSnapshotMagic.size() + payload.size() + digest->size());
+  out.append(kSnapshotMagic);
+  out.append(payload);
+  out.append(reinterpret_cast<const char *>(digest->data()), digest->size());
+}
+
+bool RoutingSnapshot::decode(const std::string &in) {
+  if (in.size() < kSnapshotMagic.size() + kSnapshotDigestSize ||
+      in.compare(0, kSnapshotMagic.size(), kSnapshotMagic) != 0)
+    return false;
+
+  const char *payload = in.data() + kSnapshotMagic.size();
+  size_t payloadSize =
+      in.size() - kSnapshotMagic.size() - kSnapshotDigestSize;
+  auto digest = computeDigest(payload, payloadSize);
+  if (!std::equal(digest->begin(), digest->end(),
+                  reinterpret_cast<const uint8_t *>(payload + payloadSize)))
+    return false;
+
+  proto::RoutingSnapshot snap;
+  if (!snap.ParseFromArray(payload, payloadSize))
+    return false;
+  auto router = [&snap](uint32_t i) {
+    return i < static_cast<uint32_t>(snap.router_size()) ? snap.router(i)
+                                                         : std::string();
+  };
+
+  routerPrefix = snap.router_prefix();
+  version = snap.version();
+  routes.clear();
+  for (const auto &route : snap.route()) {
+    RoutingEntry entry(route.prefix(), route.seq());
+    entry.SetOriginator(router(route.originator()));
+    for (const auto &nextHop : route.next_hop())
+      entry.UpsertNextHop(nextHop.face_id(), nextHop.cost(),
+                          router(nextHop.neighbor()));
+    for (const auto &path : route.path()) {
+      std::vector<std::string> routerIds;
+      for (uint32_t hop : path.hop())
+        routerIds.push_back(router(hop));
+      NextHop nextHop(routerIds);
+      entry.GetPathVectors().addPath(path.face_id(), nextHop);
+    }
+    routes[route.prefix()] = entry;
+  }
+  neighbors.clear();
+  for (const auto &neighbor : snap.neighbor())
+    neighbors.push_back(
+        {router(neighbor.name()), neighbor.face_id(), neighbor.version()});
+  return true;
+}
+
+bool RoutingSnapshot::writeFile(const std::string &path,
+                                const std::string &data) {
+  std::string tmpPath = path + ".tmp";
+  int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return false;
+  if (!writeAll(fd, data) || ::fsync(fd) != 0) {
+    int err = errno;
+    ::close(fd);
+    ::unlink(tmpPath.c_str());
+    errno = err;
+    return false;
+  }
+  ::close(fd);
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    int err = errno;
+    ::unlink(tmpPath.c_str());
+    errno = err;
+    return false;
+  }
+
+  /* make the rename itself durable */
+  auto slash = path.find_last_of('/');
+  std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+  int dirFd = ::open(dir.empty() ? "/" : dir.c_str(), O_RDONLY);
+  if (dirFd >= 0) {
+    ::fsync(dirFd);
+    ::close(dirFd);
+  }
+  return true;
+}
+
+bool RoutingSnapshot::readFile(const std::string &path, std::string &data,
+                               time::system_clock::TimePoint &mtime) {
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0)
+    return false;
+  std::ifstream is(path, std::ios::binary);
+  if (!is)
+    return false;
+  data.assign(std::istreambuf_iterator<char>(is),
+              std::istreambuf_iterator<char>());
+  mtime = time::fromUnixTimestamp(time::seconds(st.st_mtime));
+  return !is.bad();
+}
+
+} // namespace ndvr
+} // namespace ndn
@@ -0,0 +1,59 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_ROUTING_SNAPSHOT_HPP
+#define NDVR_ROUTING_SNAPSHOT_HPP
+
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/util/time.hpp>
+
+#include "routing-table.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+/** @brief On-disk copy of RoutingManager state, for warm restarts
+ *
+ * Holds the routes (seq, originator, next hops and path vectors), the
+ * version announced in Hello messages and the DvInfo version last
+ * applied from each neighbor. The payload is a proto::RoutingSnapshot
+ * between a magic header and a SHA-256 trailer; files are replaced with
+ * write-to-temporary, fsync and rename, so a crash leaves either the
+ * previous or the new snapshot, never a torn one.
+ */
+class RoutingSnapshot {
+public:
+  struct Neighbor {
+    std::string name;
+    uint64_t faceId;
+    uint64_t version;
+  };
+
+  std::string routerPrefix;
+  uint32_t version = 0;
+  RoutingTable routes;
+  std::vector<Neighbor> neighbors;
+
+  /** @brief serialize the state of rm (header, payload and trailer) */
+  static void encode(std::string &out, const std::string &routerPrefix,
+                     RoutingManager &rm,
+                     const std::vector<Neighbor> &neighbors);
+
+  /** @return false if in is not a complete, intact snapshot */
+  bool decode(const std::string &in);
+
+  /** @brief atomically replace path with data
+   * @return false (and errno set) on failure, path is then untouched */
+  static bool writeFile(const std::string &path, const std::string &data);
+
+  /** @brief read path, and when it was last written
+   * @return false if it cannot be read */
+  static bool readFile(const std::string &path, std::string &data,
+                       time::system_clock::TimePoint &mtime);
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_ROUTING_SNAPSHOT_HPP
@@ -1,4 +1,5 @@
 #include <boost/uuid/detail/sha1.hpp>
+#include <cstdio>
 #include <future> // std::promise, std::future
 #include <iostream>
 #include <sstream>
@@ -80,7 +81,7 @@ void RoutingManager::setMulticastStrategy(std::string name) {
   ::ndn::nfd::ControlParameters parameters;
   parameters.setName(name).setStrategy("/localhost/nfd/strategy/multicast");
 
-  ::ndn::nfd::CommandOptions options;
+  ::ndn::nfd::CommandOptions options = m_commandOptions;
   options.setTimeout(time::duration_cast<time::milliseconds>(time::seconds(1)));
 
   m_controller->start<nfd::StrategyChoiceSetCommand>(
@@ -103,7 +104,7 @@ void RoutingManager::enableLocalFields() {
   ndn::nfd::ControlParameters faceParameters;
   faceParameters.setFlagBit(ndn::nfd::BIT_LOCAL_FIELDS_ENABLED, true);
 
-  ::ndn::nfd::CommandOptions options;
+  ::ndn::nfd::CommandOptions options = m_commandOptions;
   options.setTimeout(time::duration_cast<time::milliseconds>(time::seconds(1)));
 
   m_controller->start<::ndn::nfd::FaceUpdateCommand>(
@@ -186,7 +187,7 @@ uint64_t RoutingManager::createFace(std::string faceUri) {
       ::ndn::nfd::FacePersistency::FACE_PERSISTENCY_PERSISTENT);
   faceId = 0;
 
-  ::ndn::nfd::CommandOptions options;
+  ::ndn::nfd::CommandOptions options = m_commandOptions;
   options.setTimeout(time::duration_cast<time::milliseconds>(time::seconds(1)));
 
   std::cerr << now_str() << "creating face uri=" << faceUri << std::endl;
@@ -226,7 +227,7 @@ void RoutingManager::registerPrefix(const std::string name, uint64_t faceId,
 
   ::ndn::nfd::ControlParameters controlParameters;
   controlParameters.setName(namePrefix).setFaceId(faceId).setCost(cost);
-  ::ndn::nfd::CommandOptions options;
+  ::ndn::nfd::CommandOptions options = m_commandOptions;
   options.setTimeout(time::duration_cast<time::milliseconds>(time::seconds(1)));
   std::cerr << now_str() << "registerPrefix call controller name=" << name
             << " faceId=" << faceId << std::endl;
@@ -289,9 +290,8 @@ void RoutingManager::unregisterPrefix(const std::string name,
           std::cerr << now_str()
                     << "unregister rib fail: code=" << resp.getCode()
                     << " error=" << resp.getText() << std::endl;
-        }
-        //,options);
-    );
+        },
+        m_commandOptions);
   } catch (const std::exception &e) {
     std::cerr << now_str() << "unregister exception: " << e.what() << std::endl;
   }
@@ -313,6 +313,13 @@ RoutingEntry *RoutingManager::LookupRoute(std::string n) {
   return &it->second;
 }
 
+RoutingEntry *RoutingManager::LongestPrefixMatch(const std::string &name) {
+  auto it = m_rt.longestPrefixMatch(name);
+  if (it == m_rt.end())
+    return nullptr;
+  return &it->second;
+}
+
 // void RoutingManager::UpdateRoute(RoutingEntry& e, uint64_t new_nh) {
 //   if (e.GetFaceId() != new_nh) {
 //     unregisterPrefix(e.GetName(), e.GetFaceId());
@@ -338,6 +345,7 @@ void RoutingManager::UpsertNextHop(RoutingEntry &e, uint64_t faceId,
             << std::endl;
   m_rt[e.GetName()] = e;
   UpdateDigest();
+  NotifyChange(e.GetName());
 }
 
 void RoutingManager::DeleteNextHop(RoutingEntry &e, uint64_t faceId) {
@@ -346,16 +354,18 @@ void RoutingManager::DeleteNextHop(RoutingEntry &e, uint64_t faceId) {
   if (!e.isNextHop(faceId))
     return;
 
-  unregisterPrefix(e.GetName(), faceId);
+  const std::string name = e.GetName();
+  unregisterPrefix(name, faceId);
   e.DeleteNextHop(faceId);
   std::cerr << now_str() << "====> done with RoutingEntry.DeleteNextHop"
             << std::endl;
   if (e.GetNextHopsSize() == 0) {
-    m_rt.erase(e.GetName());
+    m_rt.erase(name);
     UpdateDigest();
   } else {
     e.SetLearnedFrom(e.GetNextHopName(e.GetBestFaceId()));
   }
+  NotifyChange(name);
 }
 
 void RoutingManager::DeleteRoute(std::string name, uint64_t nh) {
@@ -364,21 +374,35 @@ void RoutingManager::DeleteRoute(std::string name, uint64_t nh) {
   unregisterPrefix(name, nh);
   m_rt.erase(name);
   UpdateDigest();
+  NotifyChange(name);
 }
 
 void RoutingManager::insert(RoutingEntry &e) {
   m_rt[e.GetName()] = e;
   UpdateDigest();
+  NotifyChange(e.GetName());
+}
+
+void RoutingManager::erase(const std::string &name) {
+  m_rt.erase(name);
+  UpdateDigest();
+  NotifyChange(name);
 }
 
 void RoutingManager::UpdateDigest() {
-  std::stringstream rt_str, out;
+  std::stringstream out;
   boost::uuids::detail::sha1 sha1;
   unsigned int hash[5];
-  for (auto it = m_rt.begin(); it != m_rt.end(); ++it)
-    rt_str << it->first << it->second.GetSeqNum()
-           << it->second.GetNextHopsSize();
-  sha1.process_bytes(rt_str.str().c_str(), rt_str.str().size());
+  /* same bytes as hashing "<prefix><seqNum><nextHops>" of all entries at
+   * once, without building that string */
+  char numbers[48];
+  for (auto it = m_rt.begin(); it != m_rt.end(); ++it) {
+    sha1.process_bytes(it->first.data(), it->first.size());
+    int len = snprintf(numbers, sizeof(numbers), "%llu%zu",
+                       static_cast<unsigned long long>(it->second.GetSeqNum()),
+                       it->second.GetNextHopsSize());
+    sha1.process_bytes(numbers, len);
+  }
   sha1.get_digest(hash);
   for (std::size_t i = 0; i < sizeof(hash) / sizeof(hash[0]); ++i) {
     out << std::hex << hash[i];
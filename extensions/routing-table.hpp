@@ -1,11 +1,16 @@
 #ifndef _ROUTINGTABLE_H_
 #define _ROUTINGTABLE_H_
 
+#include <algorithm>
+#include <boost/container/small_vector.hpp>
 #include <limits>
 #include <map>
 #include <ndn-cxx/mgmt/nfd/controller.hpp>
+#include <ndn-cxx/util/signal.hpp>
 #include <set>
 
+#include "name-trie.hpp"
+
 namespace ndn {
 namespace ndvr {
 
@@ -156,6 +161,17 @@ private: // faceId: 5 => [[a,b,c], [a,b,c]]
   std::string m_routerPrefix_uri;
 };
 
+/* one next hop of a RoutingEntry */
+struct RouteNextHop {
+  uint64_t faceId;
+  uint32_t cost;
+  /* neighbor the route was learned from ("" for local routes) */
+  std::string neighName;
+};
+
+/* most prefixes have 1 to 4 next hops: keep them inline */
+typedef boost::container::small_vector<RouteNextHop, 4> RouteNextHops;
+
 class RoutingEntry {
 public:
   RoutingEntry() {}
@@ -202,38 +218,49 @@ public:
   uint64_t GetSeqNum() { return m_seqNum; }
 
   void UpsertNextHop(uint64_t faceId, uint32_t cost, std::string neighName) {
-    std::cerr << "====> begin UpsertNextHop faceid=" << faceId << std::endl;
-    m_nextHops[faceId] = std::make_tuple(cost, neighName);
-    UpdateBestCost();
-    // if (m_bestFaceId == 0 || cost < m_bestCost) {
-    //   m_bestFaceId = faceId;
-    //   m_bestCost = cost;
-    // }
+    auto it = FindNextHop(faceId);
+    if (it != m_nextHops.end() && it->faceId == faceId) {
+      uint32_t oldCost = it->cost;
+      it->cost = cost;
+      it->neighName = std::move(neighName);
+      OnCostChange(faceId, oldCost, cost);
+      if (faceId == m_bestFaceId && faceId != 0)
+        SetLearnedFrom(it->neighName);
+      return;
+    }
+    m_nextHops.insert(it, RouteNextHop{faceId, cost, std::move(neighName)});
+    if (!isInfinity(cost))
+      m_validNextHops++;
+    if (m_nextHops.size() == 1)
+      UpdateBestCost(); /* drop the costs set by the constructors */
+    else
+      OnCostDecrease(faceId, cost);
   }
 
   void SetNextHopCost(uint64_t faceId, uint32_t cost) {
-    auto it = m_nextHops.find(faceId);
-    if (it == m_nextHops.end())
+    auto it = FindNextHop(faceId);
+    if (it == m_nextHops.end() || it->faceId != faceId)
       return;
-    std::get<0>(it->second) = cost;
+    uint32_t oldCost = it->cost;
+    it->cost = cost;
     // this will send the infinity cost to neighbors even if we have other
     // routes
     // if (faceId == m_bestFaceId)
     //  m_bestCost = cost;
-    UpdateBestCost();
+    OnCostChange(faceId, oldCost, cost);
   }
 
-  uint32_t GetCost(uint64_t faceId) {
-    auto it = m_nextHops.find(faceId);
-    if (it != m_nextHops.end())
-      return std::get<0>(it->second);
+  uint32_t GetCost(uint64_t faceId) const {
+    auto it = FindNextHop(faceId);
+    if (it != m_nextHops.end() && it->faceId == faceId)
+      return it->cost;
     return std::numeric_limits<uint32_t>::max();
   }
 
-  std::string GetNextHopName(uint64_t faceId) {
-    auto it = m_nextHops.find(faceId);
-    if (it != m_nextHops.end())
-      return std::get<1>(it->second);
+  std::string GetNextHopName(uint64_t faceId) const {
+    auto it = FindNextHop(faceId);
+    if (it != m_nextHops.end() && it->faceId == faceId)
+      return it->neighName;
     return "";
   }
 
@@ -244,59 +271,51 @@ public:
   uint64_t GetBestFaceId() { return m_bestFaceId; }
 
   void DeleteNextHop(uint64_t faceId) {
-    std::cerr << "====> begin DeleteNextHop" << std::endl;
-    m_nextHops.erase(faceId);
-    UpdateBestCost();
+    auto it = FindNextHop(faceId);
+    if (it == m_nextHops.end() || it->faceId != faceId)
+      return;
+    uint32_t oldCost = it->cost;
+    m_nextHops.erase(it);
+    if (!isInfinity(oldCost))
+      m_validNextHops--;
+    if (faceId == m_bestFaceId || oldCost <= m_secBestCost)
+      UpdateBestCost();
   }
 
   void UpdateBestCost() {
-    std::cerr << "====> begin UpdateBestCost " << m_name << std::endl;
     m_bestFaceId = 0;
     m_bestCost = std::numeric_limits<uint32_t>::max();
     m_secBestCost = std::numeric_limits<uint32_t>::max();
-    for (auto it = m_nextHops.begin(); it != m_nextHops.end(); ++it) {
-      std::cerr << "====> step UpdateBestCost faceid=" << it->first
-                << std::endl;
-      if (std::get<0>(it->second) < m_bestCost) {
+    for (const auto &nextHop : m_nextHops) {
+      if (nextHop.cost < m_bestCost) {
         m_secBestCost = m_bestCost;
-        m_bestCost = std::get<0>(it->second);
-        m_bestFaceId = it->first;
-        std::cerr << "====> new faceId=" << m_bestFaceId
-                  << " m_bestCost=" << m_bestCost
-                  << " m_secBestCost=" << m_secBestCost << std::endl;
-      } else if (std::get<0>(it->second) < m_secBestCost) {
-        m_secBestCost = std::get<0>(it->second);
-        std::cerr << "====> new  m_secBestCost=" << m_secBestCost << std::endl;
+        m_bestCost = nextHop.cost;
+        m_bestFaceId = nextHop.faceId;
+      } else if (nextHop.cost < m_secBestCost) {
+        m_secBestCost = nextHop.cost;
       }
     }
     if (m_bestFaceId != 0) {
       SetLearnedFrom(GetNextHopName(m_bestFaceId));
-      std::cerr << "====> SetLearnedFrom=" << GetNextHopName(m_bestFaceId)
-                << std::endl;
     }
-    std::cerr << "====> end UpdateBestCost" << std::endl;
   }
 
-  size_t GetNextHopsSize() {
-    // we cannot just return the map size, because some next hops are actualy
-    // invalid, i.e. infinity cost
-    // return m_nextHops.size();
-    size_t validHopsSize = 0;
-    for (auto it = m_nextHops.begin(); it != m_nextHops.end(); ++it)
-      if (std::get<0>(it->second) != std::numeric_limits<uint32_t>::max())
-        validHopsSize += 1;
-    return validHopsSize;
-  }
+  /* next hops with a valid (not infinity) cost */
+  size_t GetNextHopsSize() const { return m_validNextHops; }
 
-  bool isNextHop(uint64_t faceId) {
-    return m_nextHops.find(faceId) != m_nextHops.end();
+  bool isNextHop(uint64_t faceId) const {
+    auto it = FindNextHop(faceId);
+    return it != m_nextHops.end() && it->faceId == faceId;
   }
 
+  /* sorted by faceId, including infinity cost next hops */
+  const RouteNextHops &GetNextHops() const { return m_nextHops; }
+
   std::string getNextHopsStr() {
     std::string result;
-    for (auto it = m_nextHops.begin(); it != m_nextHops.end(); ++it)
-      result.append("faceid=" + std::to_string(it->first) + " (cost=" +
-                    std::to_string(std::get<0>(it->second)) + "), ");
+    for (const auto &nextHop : m_nextHops)
+      result.append("faceid=" + std::to_string(nextHop.faceId) + " (cost=" +
+                    std::to_string(nextHop.cost) + "), ");
     return result.substr(0, result.size() - 2);
   }
 
@@ -315,25 +334,83 @@ public:
 
   uint32_t GetCost() { return m_cost; }
 
+  /* local prefix announced only through a covering aggregate (see
+   * Ndvr::UpdateAggregates), left out of the DvInfo */
+  void SetSuppressed(bool suppressed) { m_suppressed = suppressed; }
+  bool IsSuppressed() const { return m_suppressed; }
+
+  /* covering prefix created by Ndvr::UpdateAggregates, not configured */
+  void SetAggregate(bool aggregate) { m_aggregate = aggregate; }
+  bool IsAggregate() const { return m_aggregate; }
+
 private:
+  static bool isInfinity(uint32_t cost) {
+    return cost == std::numeric_limits<uint32_t>::max();
+  }
+
+  RouteNextHops::iterator FindNextHop(uint64_t faceId) {
+    return std::lower_bound(
+        m_nextHops.begin(), m_nextHops.end(), faceId,
+        [](const RouteNextHop &nh, uint64_t id) { return nh.faceId < id; });
+  }
+
+  RouteNextHops::const_iterator FindNextHop(uint64_t faceId) const {
+    return std::lower_bound(
+        m_nextHops.begin(), m_nextHops.end(), faceId,
+        [](const RouteNextHop &nh, uint64_t id) { return nh.faceId < id; });
+  }
+
+  /* Keep best/second best up to date after faceId went from oldCost to
+   * cost; only a worse best (or second best) needs a rescan */
+  void OnCostChange(uint64_t faceId, uint32_t oldCost, uint32_t cost) {
+    if (isInfinity(oldCost) && !isInfinity(cost))
+      m_validNextHops++;
+    else if (!isInfinity(oldCost) && isInfinity(cost))
+      m_validNextHops--;
+
+    if (cost < oldCost && faceId != m_bestFaceId)
+      OnCostDecrease(faceId, cost);
+    else if (cost > oldCost && (faceId == m_bestFaceId || oldCost <= m_secBestCost))
+      UpdateBestCost();
+    else if (cost < oldCost) /* the best got better */
+      m_bestCost = cost;
+  }
+
+  /* faceId (not the best) was added or got cheaper */
+  void OnCostDecrease(uint64_t faceId, uint32_t cost) {
+    if (cost < m_bestCost || (cost == m_bestCost && faceId < m_bestFaceId)) {
+      m_secBestCost = m_bestCost;
+      m_bestCost = cost;
+      m_bestFaceId = faceId;
+      if (m_bestFaceId != 0)
+        SetLearnedFrom(GetNextHopName(m_bestFaceId));
+    } else if (cost < m_secBestCost) {
+      m_secBestCost = cost;
+    }
+  }
+
   std::string m_name;
   std::string m_originator;
-  uint64_t m_seqNum;
-  uint64_t m_bestFaceId;
-  uint32_t m_bestCost;
-  uint32_t m_cost;
-  /* nextHops map is indexed by faceId and has as values a tuple
-   * of <cost, neighName>. The cost is used to rank reachability to
-   * that neighbor. The neighName is used together with m_learnedFrom
-   * when processing the DvInfo and avoid local loops (i.e., learn a
-   * route from a neighbor who learned only from ourselves)
+  uint64_t m_seqNum = 0;
+  uint64_t m_bestFaceId = 0;
+  uint32_t m_bestCost = std::numeric_limits<uint32_t>::max();
+  uint32_t m_cost = std::numeric_limits<uint32_t>::max();
+  /* nextHops are kept sorted by faceId, inline for the usual few next
+   * hops. The cost is used to rank reachability to that neighbor. The
+   * neighName is used together with m_learnedFrom when processing the
+   * DvInfo and avoid local loops (i.e., learn a route from a neighbor
+   * who learned only from ourselves)
    */
-  std::map<uint64_t, std::tuple<uint32_t, std::string>> m_nextHops;
+  RouteNextHops m_nextHops;
+  uint32_t m_validNextHops = 0;
   /* variables used when processing the dvinfo */
   std::string m_learnedFrom;
-  uint32_t m_secBestCost;
+  uint32_t m_secBestCost = std::numeric_limits<uint32_t>::max();
   // path vector
   PathVectors m_pathvectors;
+  /* prefix aggregation (local routes only) */
+  bool m_suppressed = false;
+  bool m_aggregate = false;
 };
 
 /**
@@ -345,17 +422,18 @@ private:
  */
 typedef std::map<std::string, RoutingEntry> RoutingTable;
 
+/* routing table of this router, indexed by name component */
+typedef NameTrie<RoutingEntry> RoutingTrie;
+
 // class RoutingTable : public std::map<std::string, RoutingEntry> {
 class RoutingManager {
 public:
-  /* The fact that the elements in a map are always sorted by its key
-   * is important for us for the digest calculation */
-  RoutingTable m_rt;
-
-  RoutingManager() : m_version(1), m_digest("0") {}
+  /* The fact that the elements are always iterated in the same (name
+   * component) order is important for us for the digest calculation */
+  RoutingTrie m_rt;
 
   RoutingManager(ndn::Face &face, ndn::KeyChain &keyChain)
-      : m_version(1), m_digest("0"), m_face(face.getIoService()) {
+      : m_version(1), m_digest("0"), m_face(face) {
     m_controller = new ndn::nfd::Controller(face, keyChain);
     // m_netmon = make_shared<ndn::net::NetworkMonitor>(face.getIoService());
   }
@@ -367,10 +445,13 @@ public:
   void DeleteRoute(std::string name, uint64_t nh);
   bool isDirectRoute(std::string n);
   RoutingEntry *LookupRoute(std::string n);
+  /* the most specific route covering name, if any */
+  RoutingEntry *LongestPrefixMatch(const std::string &name);
   void UpsertNextHop(RoutingEntry &e, uint64_t faceId, uint32_t cost,
                      std::string neighName);
   void DeleteNextHop(RoutingEntry &e, uint64_t nh);
   void insert(RoutingEntry &e);
+  void erase(const std::string &name);
   void UpdateDigest();
   void unregisterPrefix(const std::string name, const uint64_t faceId);
   void registerPrefix(std::string name, uint64_t faceId, uint32_t cost,
@@ -379,7 +460,16 @@ public:
   void enableLocalFields();
   void setMulticastStrategy(std::string name);
 
+  /* Signing used for NFD management commands. Defaults to the key chain
+   * default identity; the emulation harness uses a digest signature to
+   * keep command signing out of its measurements */
+  void setCommandSigningInfo(const ndn::security::SigningInfo &signingInfo) {
+    m_commandOptions.setSigningInfo(signingInfo);
+  }
+
   uint32_t GetVersion() { return m_version; }
+  /* restore the version announced before a restart (see RoutingSnapshot) */
+  void SetVersion(uint32_t version) { m_version = version; }
   void IncVersion() {
     m_version++;
     UpdateDigest();
@@ -388,6 +478,13 @@ public:
   std::string GetDigest() const { return m_digest; }
   void SetDigest(std::string s) { m_digest = s; }
 
+  /* Route change notification (see NdvrApiProcessor). The methods above
+   * report the prefixes they touch; code that modifies a RoutingEntry in
+   * place must call NotifyChange itself. Listeners see every mutation and
+   * are expected to coalesce them. */
+  ndn::util::Signal<RoutingManager, std::string> afterRouteChange;
+  void NotifyChange(const std::string &name) { afterRouteChange(name); }
+
   // just forward some methods
   decltype(m_rt.begin()) begin() { return m_rt.begin(); }
   decltype(m_rt.end()) end() { return m_rt.end(); }
@@ -407,8 +504,9 @@ private:
 private:
   uint32_t m_version;
   std::string m_digest;
-  ndn::Face m_face;
+  ndn::Face &m_face;
   ndn::nfd::Controller *m_controller;
+  ::ndn::nfd::CommandOptions m_commandOptions;
   // shared_ptr<ndn::net::NetworkMonitor> m_netmon;
 };
 
@@ -21,7 +21,11 @@ public:
       .SetParent<Application>()
       .AddConstructor<SimplePubSubApp>()
       .AddAttribute("SyncDataRounds", "Number of rounds to run the sync data process", IntegerValue(0),
-                    MakeIntegerAccessor(&SimplePubSubApp::syncDataRounds_), MakeIntegerChecker<int32_t>());
+                    MakeIntegerAccessor(&SimplePubSubApp::syncDataRounds_), MakeIntegerChecker<int32_t>())
+      .AddAttribute("StateVectorSync", "Sync with state vectors instead of a notify per name", BooleanValue(false),
+                    MakeBooleanAccessor(&SimplePubSubApp::stateVectorSync_), MakeBooleanChecker())
+      .AddAttribute("FetchWindow", "Max Interests in flight to fetch missing data (state vector sync)", UintegerValue(8),
+                    MakeUintegerAccessor(&SimplePubSubApp::fetchWindow_), MakeUintegerChecker<uint32_t>(1));
     return tid;
   }
 
@@ -29,6 +33,7 @@ protected:
   virtual void StartApplication() {
     m_instance.reset(new ::ndn::ndvr::SimplePubSub());
     m_instance->SetSyncDataRounds(syncDataRounds_);
+    m_instance->SetStateVectorSync(stateVectorSync_, fetchWindow_);
     m_instance->Start();
   }
 
@@ -40,6 +45,8 @@ protected:
 private:
   std::unique_ptr<::ndn::ndvr::SimplePubSub> m_instance;
   uint32_t syncDataRounds_;      // number of rounds to sync data (for data sync experiment)
+  bool stateVectorSync_;
+  uint32_t fetchWindow_;
 };
 
 } // namespace ns3
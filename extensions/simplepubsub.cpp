@@ -12,6 +12,7 @@
 #include <ns3/node.h>
 #include <ns3/node-list.h>
 #include <ns3/ndnSIM/helper/ndn-stack-helper.hpp>
+#include <ndn-cxx/encoding/block-helpers.hpp>
 #include <ndn-cxx/lp/tags.hpp>
 
 #include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
@@ -22,6 +23,16 @@ NS_LOG_COMPONENT_DEFINE("ndn.SimplePubSub");
 namespace ndn {
 namespace ndvr {
 
+static const Name kStateVectorName("/simplepubsub/syncNotify/sv");
+/* state vector entries, in the ApplicationParameters */
+static const uint32_t kNodeIdType = 128;
+static const uint32_t kRoundType = 129;
+static const time::milliseconds kStateVectorInterval(1000);
+/* a node seeing an outdated state vector answers within this delay, random
+ * so that the neighbors of the outdated node do not all answer at once */
+static const time::milliseconds kStateVectorReplyDelay(200);
+static const uint32_t kMaxFetchRetx = 3;
+
 SimplePubSub::SimplePubSub()
   : m_scheduler(m_face.getIoService())
   , m_validator(m_face)
@@ -39,8 +50,11 @@ void SimplePubSub::Start() {
   if (m_syncDataRounds) {
     m_scheduler.schedule(ndn::time::milliseconds(4000 + 10*m_nodeid),
                         [this] { AddNewNamePrefix(1); });
-    m_scheduler.schedule(ndn::time::milliseconds(4000 + 11*m_nodeid),
-                        [this] { CheckPendingSync(); });
+    if (m_stateVectorSync)
+      ScheduleStateVector(kStateVectorInterval);
+    else
+      m_scheduler.schedule(ndn::time::milliseconds(4000 + 11*m_nodeid),
+                          [this] { CheckPendingSync(); });
   }
 }
 
@@ -84,7 +98,13 @@ void SimplePubSub::AddNewNamePrefix(uint32_t round) {
 
   NS_LOG_DEBUG("AdvName = " << namePrefix);
 
-  SendSyncNotify(namePrefix.toUri());
+  if (m_stateVectorSync) {
+    m_stateVector[m_nodeid] = round;
+    ScheduleStateVector(time::milliseconds(0));
+  }
+  else {
+    SendSyncNotify(namePrefix.toUri());
+  }
 
   m_scheduler.schedule(ndn::time::milliseconds(m_data_gen_dist(m_rengine)),
                       [this, round] { AddNewNamePrefix(round+1); });
@@ -122,6 +142,12 @@ void SimplePubSub::SendSyncNotify(const std::string nameStr) {
 void
 SimplePubSub::OnSyncNotify(const ndn::Interest& interest)
 {
+  if (kStateVectorName.isPrefixOf(interest.getName())) {
+    if (m_stateVectorSync)
+      OnStateVector(interest);
+    return;
+  }
+
   if (!interest.hasApplicationParameters() || interest.getApplicationParameters().value_size() <= 0) {
     NS_LOG_INFO("SyncNotify with invalid parameters=" << interest);
     return;
@@ -152,17 +178,21 @@ void SimplePubSub::RequestSyncData(const std::string name, uint32_t retx) {
 
   m_face.expressInterest(interest,
     std::bind(&SimplePubSub::OnSyncDataContent, this, _1, _2),
-    std::bind(&SimplePubSub::OnSyncDataNack, this, _1, _2),
+    std::bind(&SimplePubSub::OnSyncDataNack, this, _1, _2, retx),
     std::bind(&SimplePubSub::OnSyncDataTimedOut, this, _1, retx));
 }
 
 void SimplePubSub::OnSyncDataTimedOut(const ndn::Interest& interest, uint32_t retx) {
   NS_LOG_DEBUG("Interest timed out for Name: " << interest.getName() << " retx=" << retx);
   //RequestSyncData(interest.getName().toUri(), retx+1);
+  if (m_stateVectorSync)
+    OnFetchDone(interest.getName().toUri(), retx, false);
 }
 
-void SimplePubSub::OnSyncDataNack(const ndn::Interest& interest, const ndn::lp::Nack& nack) {
+void SimplePubSub::OnSyncDataNack(const ndn::Interest& interest, const ndn::lp::Nack& nack, uint32_t retx) {
   NS_LOG_DEBUG("Received Nack for " << interest.getName() << " with reason: " << nack.getReason());
+  if (m_stateVectorSync)
+    OnFetchDone(interest.getName().toUri(), retx, false);
 }
 
 void SimplePubSub::OnSyncDataContent(const ndn::Interest& interest, const ndn::Data& data) {
@@ -172,6 +202,131 @@ void SimplePubSub::OnSyncDataContent(const ndn::Interest& interest, const ndn::D
   if (m_pendingSync.find(prefix) != m_pendingSync.end()) {
     m_pendingSync.erase(prefix);
   }
+  if (m_stateVectorSync)
+    OnFetchDone(prefix, 0, true);
+}
+
+void SimplePubSub::SendStateVector() {
+  Block params(ndn::tlv::ApplicationParameters);
+  for (const auto& entry : m_stateVector) {
+    params.push_back(makeNonNegativeIntegerBlock(kNodeIdType, entry.first));
+    params.push_back(makeNonNegativeIntegerBlock(kRoundType, entry.second));
+  }
+  params.encode();
+
+  Interest interest(kStateVectorName);
+  interest.setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest.setCanBePrefix(false);
+  interest.setInterestLifetime(time::milliseconds(1));
+  interest.setApplicationParameters(params);
+  NS_LOG_INFO("Sending state vector entries=" << m_stateVector.size());
+
+  m_face.expressInterest(interest, [](const Interest&, const Data&) {},
+                        [](const Interest&, const lp::Nack&) {},
+                        [](const Interest&) {});
+
+  m_nextStateVector = time::steady_clock::now() + kStateVectorInterval;
+  m_stateVectorEvent = m_scheduler.schedule(kStateVectorInterval, [this] { SendStateVector(); });
+}
+
+void SimplePubSub::ScheduleStateVector(time::milliseconds maxDelay) {
+  std::uniform_int_distribution<time::milliseconds::rep> delayDist(0, maxDelay.count());
+  time::milliseconds delay(delayDist(m_rengine));
+  auto when = time::steady_clock::now() + delay;
+  if (m_stateVectorEvent && when >= m_nextStateVector)
+    return;
+  m_nextStateVector = when;
+  m_stateVectorEvent = m_scheduler.schedule(delay, [this] { SendStateVector(); });
+}
+
+void SimplePubSub::OnStateVector(const ndn::Interest& interest) {
+  if (!interest.hasApplicationParameters())
+    return;
+
+  std::map<uint64_t, uint64_t> received;
+  try {
+    Block params = interest.getApplicationParameters();
+    params.parse();
+    const auto& elements = params.elements();
+    for (size_t i = 0; i + 1 < elements.size(); i += 2) {
+      if (elements[i].type() != kNodeIdType || elements[i + 1].type() != kRoundType)
+        throw tlv::Error("unexpected state vector entry");
+      received[readNonNegativeInteger(elements[i])] = readNonNegativeInteger(elements[i + 1]);
+    }
+  }
+  catch (const tlv::Error& e) {
+    NS_LOG_INFO("State vector with invalid parameters=" << interest << ": " << e.what());
+    return;
+  }
+
+  bool learned = false;
+  for (const auto& entry : received) {
+    if (entry.first == m_nodeid)
+      continue;
+    /* rounds given up on: the sender has them, try again */
+    auto missing = m_missingRounds.find(entry.first);
+    if (missing != m_missingRounds.end()) {
+      auto& rounds = missing->second;
+      auto end = rounds.upper_bound(entry.second);
+      for (auto it = rounds.begin(); it != end; ++it)
+        m_fetchQueue.emplace_back(MakeSyncDataName(entry.first, *it), 0);
+      learned = learned || rounds.begin() != end;
+      rounds.erase(rounds.begin(), end);
+      if (rounds.empty())
+        m_missingRounds.erase(missing);
+    }
+    /* the vector tells what was advertised, not what was fetched */
+    uint64_t& known = m_stateVector[entry.first];
+    for (uint64_t round = known + 1; round <= entry.second; round++) {
+      m_fetchQueue.emplace_back(MakeSyncDataName(entry.first, round), 0);
+      learned = true;
+    }
+    known = std::max(known, entry.second);
+  }
+
+  /* the sender misses rounds we know of: tell it (and its neighbors) */
+  for (const auto& entry : m_stateVector) {
+    auto it = received.find(entry.first);
+    if (it == received.end() || it->second < entry.second) {
+      ScheduleStateVector(kStateVectorReplyDelay);
+      break;
+    }
+  }
+
+  if (learned)
+    FetchMissingData();
+}
+
+void SimplePubSub::FetchMissingData() {
+  while (m_nFetching < m_fetchWindow && !m_fetchQueue.empty()) {
+    auto next = m_fetchQueue.front();
+    m_fetchQueue.pop_front();
+    if (m_satisfiedSync.find(next.first) != m_satisfiedSync.end())
+      continue;
+    m_nFetching++;
+    RequestSyncData(next.first, next.second);
+  }
+}
+
+void SimplePubSub::OnFetchDone(const std::string& name, uint32_t retx, bool satisfied) {
+  if (m_nFetching > 0)
+    m_nFetching--;
+  if (!satisfied && retx < kMaxFetchRetx) {
+    m_fetchQueue.emplace_back(name, retx + 1);
+  }
+  else if (!satisfied) {
+    /* until the next state vector advertising it (OnStateVector) */
+    ndn::Name dataName(name);
+    NS_LOG_DEBUG("Giving up on " << name << " for now");
+    m_missingRounds[dataName.get(2).toNumber()].insert(dataName.get(3).toNumber());
+  }
+  FetchMissingData();
+}
+
+std::string SimplePubSub::MakeSyncDataName(uint64_t nodeId, uint64_t round) {
+  ndn::Name name("/ndn/ndvrSync");
+  name.appendNumber(nodeId).appendNumber(round).appendNumber(0);
+  return name.toUri();
 }
 
 
@@ -4,7 +4,11 @@
 #define SIMPLEPUBSUB_HPP
 
 
+#include <algorithm>
+#include <deque>
 #include <iostream>
+#include <map>
+#include <set>
 #include <unordered_set>
 #include <string>
 #include <random>
@@ -22,6 +26,19 @@
 namespace ndn {
 namespace ndvr {
 
+/**
+ * Every node publishes /ndn/ndvrSync/<nodeid>/<round>/0 for round = 1, 2, ...
+ * and fetches what the others publish.
+ *
+ * By default each node floods a syncNotify per published name every second,
+ * and requests every pending name every second. In state vector mode, nodes
+ * exchange instead the latest round of every node they know of (one
+ * syncNotify/sv Interest, sent on change and every kStateVectorInterval),
+ * and fetch the rounds they miss with at most m_fetchWindow Interests in
+ * flight: sync overhead follows the number of producers, not of names.
+ * A round still missing after its retransmissions is fetched again when
+ * a state vector advertises it.
+ */
 class SimplePubSub
 {
 public:
@@ -34,17 +51,31 @@ public:
     m_syncDataRounds = x;
   }
 
+  void SetStateVectorSync(bool enabled, uint32_t fetchWindow) {
+    m_stateVectorSync = enabled;
+    m_fetchWindow = std::max<uint32_t>(1, fetchWindow);
+  }
+
 private:
   void registerPrefixes();
   void RequestSyncData(const std::string name, uint32_t retx = 0);
   void AddNewNamePrefix(uint32_t round);
   void OnSyncDataTimedOut(const ndn::Interest& interest, uint32_t retx);
-  void OnSyncDataNack(const ndn::Interest& interest, const ndn::lp::Nack& nack);
+  void OnSyncDataNack(const ndn::Interest& interest, const ndn::lp::Nack& nack, uint32_t retx);
   void OnSyncDataContent(const ndn::Interest& interest, const ndn::Data& data);
   void SendSyncNotify(const std::string nameStr);
   void OnSyncNotify(const ndn::Interest& interest);
   void CheckPendingSync();
 
+  /* state vector mode */
+  void SendStateVector();
+  /* send the state vector within a short random delay, unless sooner */
+  void ScheduleStateVector(time::milliseconds maxDelay);
+  void OnStateVector(const ndn::Interest& interest);
+  void FetchMissingData();
+  void OnFetchDone(const std::string& name, uint32_t retx, bool satisfied);
+  static std::string MakeSyncDataName(uint64_t nodeId, uint64_t round);
+
 private:
   ndn::Scheduler m_scheduler;
   ndn::Face m_face;
@@ -62,6 +93,19 @@ private:
 
   std::unordered_set<std::string> m_pendingSync;
   std::unordered_set<std::string> m_satisfiedSync;
+
+  bool m_stateVectorSync = false;
+  uint32_t m_fetchWindow = 8;
+  /* node id => latest round published (advertised, not necessarily
+   * fetched yet) */
+  std::map<uint64_t, uint64_t> m_stateVector;
+  /* node id => rounds not fetched after kMaxFetchRetx retransmissions */
+  std::map<uint64_t, std::set<uint64_t>> m_missingRounds;
+  scheduler::ScopedEventId m_stateVectorEvent;
+  time::steady_clock::TimePoint m_nextStateVector;
+  /* names to fetch, with their retransmission count */
+  std::deque<std::pair<std::string, uint32_t>> m_fetchQueue;
+  uint32_t m_nFetching = 0;
 };
 
 } // namespace ndvr
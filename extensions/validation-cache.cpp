@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "validation-cache.hpp"
+
+#include <ndn-cxx/security/v2/certificate-request.hpp>
+#include <ndn-cxx/security/v2/validation-state.hpp>
+
+#include <boost/property_tree/info_parser.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+bool ValidationCache::contains(const Data &data) {
+  auto it = m_index.find(getDigest(data));
+  if (it == m_index.end()) {
+    m_nMisses++;
+    return false;
+  }
+  if (it->second->expiry < time::steady_clock::now()) {
+    erase(it->second);
+    m_nMisses++;
+    return false;
+  }
+  m_nHits++;
+  return true;
+}
+
+void ValidationCache::insert(const Data &data) {
+  if (m_capacity == 0)
+    return;
+
+  std::string digest = getDigest(data);
+  auto it = m_index.find(digest);
+  if (it != m_index.end())
+    erase(it->second);
+
+  /* expired entries gather at the back, drop them before evicting */
+  auto now = time::steady_clock::now();
+  while (!m_entries.empty() && (m_entries.back().expiry < now ||
+                                m_entries.size() >= m_capacity)) {
+    erase(std::prev(m_entries.end()));
+  }
+
+  m_entries.push_front(Entry{digest, now + m_ttl});
+  m_index[digest] = m_entries.begin();
+}
+
+void ValidationCache::erase(EntryList::iterator it) {
+  m_index.erase(it->digest);
+  m_entries.erase(it);
+}
+
+void RetainingCertificateFetcher::doFetch(
+    const shared_ptr<security::v2::CertificateRequest> &certRequest,
+    const shared_ptr<security::v2::ValidationState> &state,
+    const ValidationContinuation &continueValidation) {
+  const security::v2::Certificate *cert =
+      findCertificate(certRequest->interest.getName());
+  if (cert != nullptr) {
+    continueValidation(*cert, state);
+    return;
+  }
+
+  CertificateFetcherFromNetwork::doFetch(certRequest, state,
+                                         continueValidation);
+}
+
+const security::v2::Certificate *
+RetainingCertificateFetcher::findCertificate(const Name &name) {
+  auto now = time::system_clock::now();
+  for (auto it = m_certs->lower_bound(name);
+       it != m_certs->end() && name.isPrefixOf(it->first);) {
+    if (!it->second.isValid(now)) {
+      it = m_certs->erase(it);
+      continue;
+    }
+    return &it->second;
+  }
+  return nullptr;
+}
+
+void RetainingCertificateFetcher::retain(
+    const security::v2::Certificate &cert) {
+  if (cert.isValid())
+    (*m_certs)[cert.getName()] = cert;
+}
+
+void RetainingCertificateFetcher::forget(const Name &name) {
+  auto it = m_certs->lower_bound(name);
+  while (it != m_certs->end() && name.isPrefixOf(it->first))
+    it = m_certs->erase(it);
+}
+
+ConstBufferPtr VerifiedKeyCache::find(const Name &keyName,
+                                      const std::string &routerPrefix,
+                                      uint32_t sigType) {
+  auto it = m_keys.find(keyName);
+  if (it == m_keys.end())
+    return nullptr;
+  const Entry &entry = it->second;
+  if (entry.expiry < time::steady_clock::now() ||
+      entry.notAfter < time::system_clock::now()) {
+    m_keys.erase(it);
+    return nullptr;
+  }
+  if (entry.routerPrefix != routerPrefix || entry.sigType != sigType)
+    return nullptr;
+  return entry.publicKey;
+}
+
+void VerifiedKeyCache::insert(const Name &keyName,
+                              const std::string &routerPrefix,
+                              uint32_t sigType,
+                              const security::v2::Certificate &cert) {
+  m_keys[keyName] =
+      Entry{routerPrefix, sigType, make_shared<Buffer>(cert.getPublicKey()),
+            cert.getValidityPeriod().getPeriod().second,
+            time::steady_clock::now() + m_ttl};
+}
+
+const security::v2::validator_config::ConfigSection &
+getParsedValidationConfig(const std::string &filename) {
+  static std::map<std::string, security::v2::validator_config::ConfigSection>
+      parsed;
+
+  auto it = parsed.find(filename);
+  if (it != parsed.end())
+    return it->second;
+
+  security::v2::validator_config::ConfigSection section;
+  boost::property_tree::read_info(filename, section);
+  return parsed.emplace(filename, std::move(section)).first->second;
+}
+
+} // namespace ndvr
+} // namespace ndn
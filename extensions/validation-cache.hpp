@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_VALIDATION_CACHE_HPP
+#define NDVR_VALIDATION_CACHE_HPP
+
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/security/v2/certificate-fetcher-from-network.hpp>
+#include <ndn-cxx/security/v2/validator-config/common.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/** @brief Remembers DvInfo Data packets that already passed validation
+ *
+ * Entries are keyed by the implicit SHA-256 digest of the whole Data
+ * packet, so a hit means the very same bytes (name, content and
+ * signature) were validated before: the same DvInfo received again
+ * from another neighbor on a shared medium, or after a retransmission.
+ * The cache is bounded (least recently validated entry is evicted) and
+ * entries expire after a TTL, so changes in the trust anchors are
+ * picked up eventually.
+ */
+class ValidationCache {
+public:
+  ValidationCache(size_t capacity = 1024,
+                  time::nanoseconds ttl = time::seconds(60))
+      : m_capacity(capacity), m_ttl(ttl) {}
+
+  /** @brief true if data was validated less than TTL ago */
+  bool contains(const Data &data);
+
+  void insert(const Data &data);
+
+  size_t size() const { return m_entries.size(); }
+
+  uint64_t getNHits() const { return m_nHits; }
+
+  uint64_t getNMisses() const { return m_nMisses; }
+
+private:
+  struct Entry {
+    std::string digest;
+    time::steady_clock::TimePoint expiry;
+  };
+  using EntryList = std::list<Entry>;
+
+  static std::string getDigest(const Data &data) {
+    const auto &digest = data.getFullName().get(-1);
+    return std::string(reinterpret_cast<const char *>(digest.value()),
+                       digest.value_size());
+  }
+
+  void erase(EntryList::iterator it);
+
+private:
+  size_t m_capacity;
+  time::nanoseconds m_ttl;
+  /* most recently inserted at the front */
+  EntryList m_entries;
+  std::unordered_map<std::string, EntryList::iterator> m_index;
+  uint64_t m_nHits = 0;
+  uint64_t m_nMisses = 0;
+};
+
+/** @brief certificate name => certificate */
+using RetainedCertificates = std::map<Name, security::v2::Certificate>;
+
+/** @brief Certificate fetcher that keeps neighbors' certificates
+ *
+ * The validator caches verified certificates for at most one hour and
+ * then fetches them again from the neighbor (OnKeyInterest). This
+ * fetcher keeps the certificates handed to retain() until the end of
+ * their validity period and gives them back to the validator instead of
+ * going to the network. Only certificates of a chain that validated are
+ * to be retained: a certificate just fetched is not, so a bogus one
+ * cannot stand in for the neighbor's until its notAfter. The validator
+ * still verifies whatever the fetcher returns, and forget() drops a
+ * retained certificate that failed.
+ *
+ * The store can be shared by several Ndvr instances running on the same
+ * event loop (setStore), so a certificate fetched by one of them is not
+ * fetched again by the others.
+ */
+class RetainingCertificateFetcher
+    : public security::v2::CertificateFetcherFromNetwork {
+public:
+  explicit RetainingCertificateFetcher(Face &face)
+      : CertificateFetcherFromNetwork(face),
+        m_certs(make_shared<RetainedCertificates>()) {}
+
+  void setStore(shared_ptr<RetainedCertificates> certs) {
+    m_certs = std::move(certs);
+  }
+
+  size_t size() const { return m_certs->size(); }
+
+  /** @brief retained certificate whose name starts with name (e.g., a
+   * KeyLocator key name), or nullptr */
+  const security::v2::Certificate *findCertificate(const Name &name);
+
+  /** @brief keep cert, which the validator verified */
+  void retain(const security::v2::Certificate &cert);
+
+  /** @brief drop the retained certificates whose name starts with name */
+  void forget(const Name &name);
+
+protected:
+  void doFetch(const shared_ptr<security::v2::CertificateRequest> &certRequest,
+               const shared_ptr<security::v2::ValidationState> &state,
+               const ValidationContinuation &continueValidation) override;
+
+private:
+  shared_ptr<RetainedCertificates> m_certs;
+};
+
+/** @brief Neighbor keys already accepted by the validator
+ *
+ * Once the validator accepted a DvInfo of router R signed with key K,
+ * the trust rules (validation.conf) have nothing new to say about the
+ * next DvInfo of R signed with K: only its signature has to be checked,
+ * which can then be done with the public key alone, off the event loop
+ * (CryptoWorkerPool). Entries expire with the certificate or after a
+ * TTL, whichever comes first, and the validator is consulted again.
+ */
+class VerifiedKeyCache {
+public:
+  explicit VerifiedKeyCache(time::nanoseconds ttl = time::hours(1))
+      : m_ttl(ttl) {}
+
+  /** @brief public key of keyName if it was accepted for routerPrefix
+   * with the same signature type, or nullptr */
+  ConstBufferPtr find(const Name &keyName, const std::string &routerPrefix,
+                      uint32_t sigType);
+
+  void insert(const Name &keyName, const std::string &routerPrefix,
+              uint32_t sigType, const security::v2::Certificate &cert);
+
+  size_t size() const { return m_keys.size(); }
+
+private:
+  struct Entry {
+    std::string routerPrefix;
+    uint32_t sigType;
+    ConstBufferPtr publicKey;
+    time::system_clock::TimePoint notAfter;
+    time::steady_clock::TimePoint expiry;
+  };
+
+private:
+  time::nanoseconds m_ttl;
+  /* key name => entry */
+  std::map<Name, Entry> m_keys;
+};
+
+/** @brief Parsed validation rules file, read once per process
+ *
+ * Every Ndvr instance of a process (ndvrd -c, ndnSIM) loads the same
+ * rules; this keeps the parsed tree so the file is read and parsed only
+ * the first time. Not thread-safe: call it from the event-loop thread.
+ */
+const security::v2::validator_config::ConfigSection &
+getParsedValidationConfig(const std::string &filename);
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_VALIDATION_CACHE_HPP
@@ -0,0 +1,380 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "emulator.hpp"
+#include "ndvr-security-helper.hpp"
+
+#include <ndn-cxx/lp/tags.hpp>
+#include <ndn-cxx/mgmt/control-response.hpp>
+#include <ndn-cxx/mgmt/nfd/control-parameters.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/util/io.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+
+namespace ndn {
+namespace ndvr {
+namespace emu {
+
+static const Name kLocalhostNfdPrefix("/localhost/nfd");
+static const Name kLocalhopPrefix("/localhop");
+/* FaceId NFD gives to the application face; link faces start at 256 as
+ * FaceIds below that are reserved in NFD */
+static const uint64_t kAppFaceId = 1;
+static const uint64_t kFirstLinkFaceId = 256;
+
+Emulator::Emulator(const Topology& topology, const Options& options)
+  : m_steadyClock(make_shared<VirtualSteadyClock>())
+  , m_systemClock(make_shared<VirtualSystemClock>(time::system_clock::now()))
+  , m_keyChain("pib-memory:", "tpm-memory:")
+  , m_scheduler(m_io)
+  , m_options(options)
+  , m_rengine(options.seed)
+  , m_lossDist(0.0, 1.0)
+{
+  time::setCustomClocks(m_steadyClock, m_systemClock);
+  m_startTime = m_steadyClock->getNow();
+
+  std::set<std::string> allPrefixes;
+  m_routers.resize(topology.nodes.size());
+  for (size_t i = 0; i < topology.nodes.size(); ++i) {
+    Router& router = m_routers[i];
+    router.name = topology.nodes[i].name;
+    router.prefixes = topology.nodes[i].prefixes;
+    if (router.prefixes.empty()) {
+      router.prefixes.push_back(Name(m_options.network.toUri() + "/" + router.name + "-site").toUri());
+    }
+    allPrefixes.insert(router.prefixes.begin(), router.prefixes.end());
+    router.nextFaceId = kFirstLinkFaceId;
+  }
+  m_nPrefixes = allPrefixes.size();
+
+  for (const auto& link : topology.links) {
+    Router& a = m_routers[link.a];
+    Router& b = m_routers[link.b];
+    uint64_t aFaceId = a.nextFaceId++;
+    uint64_t bFaceId = b.nextFaceId++;
+    a.ports[aFaceId] = Port{link.b, bFaceId, link.delay, link.loss};
+    b.ports[bFaceId] = Port{link.a, aFaceId, link.delay, link.loss};
+    a.faces.push_back(std::to_string(aFaceId));
+    b.faces.push_back(std::to_string(bFaceId));
+  }
+
+  setupSecurity();
+}
+
+Emulator::~Emulator()
+{
+  m_routers.clear();
+  time::setCustomClocks(nullptr, nullptr);
+  if (!m_workDir.empty()) {
+    std::remove((m_workDir + "/trust.cert").c_str());
+    std::remove((m_workDir + "/validation.conf").c_str());
+    ::rmdir(m_workDir.c_str());
+  }
+}
+
+void
+Emulator::setupSecurity()
+{
+  char dirTemplate[] = "/tmp/ndvr-emu-XXXXXX";
+  if (::mkdtemp(dirTemplate) == nullptr)
+    throw Error("Failed to create emulator work directory");
+  m_workDir = dirTemplate;
+
+  std::string validationConf;
+  if (m_options.validationConfig.empty()) {
+    validationConf = "trust-anchor\n{\n  type any\n}\n";
+  }
+  else {
+    std::ifstream is(m_options.validationConfig);
+    if (!is)
+      throw Error("Cannot open validation config " + m_options.validationConfig);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    validationConf = ss.str();
+  }
+  std::ofstream(m_workDir + "/validation.conf") << validationConf;
+
+  /* network root (trust anchor) and one certificate per router signed by
+   * it, the same chain minindn/apps/ndvr.py builds with ndnsec */
+  security::Identity root = m_keyChain.createIdentity(m_options.network);
+  io::save(root.getDefaultKey().getDefaultCertificate(), m_workDir + "/trust.cert");
+
+  for (auto& router : m_routers) {
+    Name routerName = Name(m_options.network).append(Name("/" + kRouterTag + "/" + router.name));
+    router.signingInfo = setupSigningInfo(m_keyChain, routerName, m_options.network);
+  }
+}
+
+void
+Emulator::start()
+{
+  for (size_t i = 0; i < m_routers.size(); ++i) {
+    Router& router = m_routers[i];
+    router.face = make_unique<util::DummyClientFace>(m_io, m_keyChain,
+                                                     util::DummyClientFace::Options{false, false});
+    router.face->onSendInterest.connect([this, i] (const Interest& interest) {
+      onSendInterest(i, interest);
+    });
+    router.face->onSendData.connect([this, i] (const Data& data) {
+      onSendData(i, data);
+    });
+
+    Name routerName("/" + kRouterTag + "/" + router.name);
+    router.ndvr = make_unique<Ndvr>(*router.face, m_keyChain, router.signingInfo,
+                                    m_options.network, routerName, router.prefixes,
+                                    router.faces, router.monitorFaces,
+                                    m_workDir + "/validation.conf");
+    router.ndvr->EnableUnicastFaces(false);
+    router.ndvr->getRoutingTable().setCommandSigningInfo(security::signingWithSha256());
+    if (m_options.helloInterval != 0)
+      router.ndvr->SetHelloInterval(m_options.helloInterval);
+  }
+
+  for (auto& router : m_routers) {
+    router.ndvr->Start();
+  }
+}
+
+void
+Emulator::advance(time::nanoseconds duration)
+{
+  time::nanoseconds elapsed(0);
+  while (elapsed < duration) {
+    m_steadyClock->advance(m_options.tick);
+    m_systemClock->advance(m_options.tick);
+    elapsed += m_options.tick;
+    m_io.poll();
+    if (m_io.stopped())
+      m_io.reset();
+  }
+}
+
+bool
+Emulator::isConverged()
+{
+  for (auto& router : m_routers) {
+    if (router.ndvr->getRoutingTable().size() < m_nPrefixes)
+      return false;
+  }
+  return true;
+}
+
+const std::map<uint64_t, uint64_t>*
+Emulator::lookupFib(const Router& router, const Name& name) const
+{
+  for (size_t len = name.size() + 1; len > 0; --len) {
+    auto it = router.fib.find(name.getPrefix(len - 1));
+    if (it != router.fib.end() && !it->second.empty())
+      return &it->second;
+  }
+  return nullptr;
+}
+
+void
+Emulator::onSendInterest(size_t idx, const Interest& interest)
+{
+  if (kLocalhostNfdPrefix.isPrefixOf(interest.getName())) {
+    processNfdCommand(idx, interest);
+    return;
+  }
+
+  const Router& router = m_routers[idx];
+  auto nexthops = lookupFib(router, interest.getName());
+  if (nexthops == nullptr)
+    return;
+
+  /* NDVR sets the multicast strategy on its localhop namespace; anything
+   * else goes to the lowest-cost next hop (best-route) */
+  if (kLocalhopPrefix.isPrefixOf(interest.getName())) {
+    for (const auto& nh : *nexthops) {
+      if (nh.first != kAppFaceId)
+        transmit(idx, nh.first, interest);
+    }
+    return;
+  }
+
+  uint64_t bestFaceId = 0;
+  uint64_t bestCost = std::numeric_limits<uint64_t>::max();
+  for (const auto& nh : *nexthops) {
+    if (nh.first != kAppFaceId && nh.second < bestCost) {
+      bestFaceId = nh.first;
+      bestCost = nh.second;
+    }
+  }
+  if (bestFaceId != 0)
+    transmit(idx, bestFaceId, interest);
+}
+
+void
+Emulator::onSendData(size_t idx, const Data& data)
+{
+  Router& router = m_routers[idx];
+  auto now = time::steady_clock::now();
+  for (auto it = router.pit.begin(); it != router.pit.end();) {
+    if (it->expiry < now) {
+      it = router.pit.erase(it);
+      continue;
+    }
+    if (it->interest.matchesData(data)) {
+      transmit(idx, it->inFaceId, data);
+      it = router.pit.erase(it);
+      continue;
+    }
+    ++it;
+  }
+}
+
+void
+Emulator::transmit(size_t idx, uint64_t faceId, const Interest& interest)
+{
+  auto portIt = m_routers[idx].ports.find(faceId);
+  if (portIt == m_routers[idx].ports.end())
+    return;
+  const Port& port = portIt->second;
+
+  countPacket(interest.getName(), false, interest.wireEncode().size());
+  if (port.loss > 0 && m_lossDist(m_rengine) < port.loss) {
+    m_counters.nLost++;
+    return;
+  }
+
+  size_t peer = port.peer;
+  uint64_t inFaceId = port.peerFaceId;
+  m_scheduler.schedule(port.delay, [this, peer, inFaceId, interest] {
+    Router& router = m_routers[peer];
+    if (interest.getInterestLifetime() > time::milliseconds::zero()) {
+      auto now = time::steady_clock::now();
+      while (!router.pit.empty() && router.pit.front().expiry < now)
+        router.pit.pop_front();
+      router.pit.push_back(PitEntry{interest, inFaceId, now + interest.getInterestLifetime()});
+    }
+    Interest received(interest);
+    received.setTag(make_shared<lp::IncomingFaceIdTag>(inFaceId));
+    router.face->receive(received);
+  });
+}
+
+void
+Emulator::transmit(size_t idx, uint64_t faceId, const Data& data)
+{
+  auto portIt = m_routers[idx].ports.find(faceId);
+  if (portIt == m_routers[idx].ports.end())
+    return;
+  const Port& port = portIt->second;
+
+  countPacket(data.getName(), true, data.wireEncode().size());
+  if (port.loss > 0 && m_lossDist(m_rengine) < port.loss) {
+    m_counters.nLost++;
+    return;
+  }
+
+  size_t peer = port.peer;
+  uint64_t inFaceId = port.peerFaceId;
+  m_scheduler.schedule(port.delay, [this, peer, inFaceId, data] {
+    Data received(data);
+    received.setTag(make_shared<lp::IncomingFaceIdTag>(inFaceId));
+    m_routers[peer].face->receive(received);
+  });
+}
+
+void
+Emulator::processNfdCommand(size_t idx, const Interest& interest)
+{
+  const Name& name = interest.getName();
+  if (name.size() <= kLocalhostNfdPrefix.size() + 2)
+    return; // e.g. faces/events notification stream, left unanswered
+
+  m_counters.nNfdCommands++;
+  std::string module = name.get(kLocalhostNfdPrefix.size()).toUri();
+  std::string verb = name.get(kLocalhostNfdPrefix.size() + 1).toUri();
+
+  nfd::ControlParameters params;
+  try {
+    params.wireDecode(name.get(kLocalhostNfdPrefix.size() + 2).blockFromValue());
+  }
+  catch (const tlv::Error&) {
+    return;
+  }
+
+  Router& router = m_routers[idx];
+  uint32_t code = 200;
+  if (module == "rib" && verb == "register") {
+    if (!params.hasFaceId() || params.getFaceId() == 0)
+      params.setFaceId(kAppFaceId);
+    if (!params.hasOrigin())
+      params.setOrigin(nfd::ROUTE_ORIGIN_APP);
+    if (!params.hasCost())
+      params.setCost(0);
+    if (!params.hasFlags())
+      params.setFlags(nfd::ROUTE_FLAG_CHILD_INHERIT);
+    router.fib[params.getName()][params.getFaceId()] = params.getCost();
+  }
+  else if (module == "rib" && verb == "unregister") {
+    if (!params.hasFaceId() || params.getFaceId() == 0)
+      params.setFaceId(kAppFaceId);
+    if (!params.hasOrigin())
+      params.setOrigin(nfd::ROUTE_ORIGIN_APP);
+    auto it = router.fib.find(params.getName());
+    if (it != router.fib.end()) {
+      it->second.erase(params.getFaceId());
+      if (it->second.empty())
+        router.fib.erase(it);
+    }
+  }
+  else if (module == "faces" && verb == "update") {
+    params.setFaceId(kAppFaceId);
+    params.setFacePersistency(nfd::FACE_PERSISTENCY_PERSISTENT);
+    if (!params.hasFlags())
+      params.setFlags(0);
+    params.unsetMask();
+  }
+  else if (module == "strategy-choice" && verb == "set") {
+    // nothing to do: localhop forwarding is always multicast here
+  }
+  else {
+    code = 501;
+  }
+
+  nfd::ControlResponse response(code, code == 200 ? "OK" : "Not emulated");
+  if (code == 200)
+    response.setBody(params.wireEncode());
+
+  auto data = make_shared<Data>(name);
+  data->setContent(response.wireEncode());
+  m_keyChain.sign(*data, security::signingWithSha256());
+
+  util::DummyClientFace& face = *router.face;
+  m_io.post([&face, data] { face.receive(*data); });
+}
+
+void
+Emulator::countPacket(const Name& name, bool isData, size_t size)
+{
+  if (kNdvrHelloPrefix.isPrefixOf(name)) {
+    m_counters.nHelloInterests++;
+  }
+  else if (kNdvrDvInfoPrefix.isPrefixOf(name)) {
+    if (isData) {
+      m_counters.nDvInfoData++;
+      m_counters.nDvInfoBytes += size;
+    }
+    else {
+      m_counters.nDvInfoInterests++;
+    }
+  }
+  else if (isData) {
+    m_counters.nKeyData++;
+  }
+  else {
+    m_counters.nKeyInterests++;
+  }
+}
+
+} // namespace emu
+} // namespace ndvr
+} // namespace ndn
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_EMU_EMULATOR_HPP
+#define NDVR_EMU_EMULATOR_HPP
+
+#include "ndvr.hpp"
+#include "topology.hpp"
+#include "virtual-clock.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <list>
+#include <random>
+
+namespace ndn {
+namespace ndvr {
+namespace emu {
+
+/** @brief Runs many Ndvr instances in one process over emulated links
+ *
+ * Every router gets a DummyClientFace bound to a shared io_service and a
+ * shared in-memory KeyChain. The emulator plays the role of each router's
+ * NFD: it answers /localhost/nfd management commands (the stub behind
+ * RoutingManager's nfd::Controller), keeps a per-router FIB built from
+ * those commands, and moves packets across links with the configured
+ * delay and loss. Only one-hop traffic is modelled (hellos, DvInfo and
+ * certificate fetches), which is everything NDVR itself exchanges.
+ *
+ * Time is virtual: advance() moves the custom steady/system clocks in
+ * fixed ticks and polls the io_service in between.
+ */
+class Emulator
+{
+public:
+  struct Options
+  {
+    Name network = Name("/ndn");
+    int helloInterval = 0;
+    /* validation rules; empty disables signature validation */
+    std::string validationConfig;
+    time::nanoseconds tick = time::milliseconds(1);
+    uint32_t seed = 1;
+  };
+
+  struct Counters
+  {
+    uint64_t nHelloInterests = 0;
+    uint64_t nDvInfoInterests = 0;
+    uint64_t nDvInfoData = 0;
+    uint64_t nDvInfoBytes = 0;
+    uint64_t nKeyInterests = 0;
+    uint64_t nKeyData = 0;
+    uint64_t nNfdCommands = 0;
+    uint64_t nLost = 0;
+  };
+
+  Emulator(const Topology& topology, const Options& options);
+
+  ~Emulator();
+
+  void
+  start();
+
+  void
+  advance(time::nanoseconds duration);
+
+  /** @brief true when every router has a route to every advertised prefix */
+  bool
+  isConverged();
+
+  time::nanoseconds
+  getElapsed() const
+  {
+    return m_steadyClock->getNow() - m_startTime;
+  }
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+  size_t
+  getNRouters() const
+  {
+    return m_routers.size();
+  }
+
+private:
+  struct Port
+  {
+    size_t peer;
+    uint64_t peerFaceId;
+    time::nanoseconds delay;
+    double loss;
+  };
+
+  struct PitEntry
+  {
+    Interest interest;
+    uint64_t inFaceId;
+    time::steady_clock::TimePoint expiry;
+  };
+
+  struct Router
+  {
+    std::string name;
+    std::vector<std::string> prefixes;
+    std::vector<std::string> faces;
+    std::vector<std::string> monitorFaces;
+    security::SigningInfo signingInfo;
+    std::unique_ptr<util::DummyClientFace> face;
+    std::unique_ptr<Ndvr> ndvr;
+    std::map<uint64_t, Port> ports;
+    /* prefix => faceId => cost, as registered through rib/register */
+    std::map<Name, std::map<uint64_t, uint64_t>> fib;
+    std::list<PitEntry> pit;
+    uint64_t nextFaceId;
+  };
+
+  void
+  setupSecurity();
+
+  void
+  onSendInterest(size_t idx, const Interest& interest);
+
+  void
+  onSendData(size_t idx, const Data& data);
+
+  void
+  processNfdCommand(size_t idx, const Interest& interest);
+
+  void
+  transmit(size_t idx, uint64_t faceId, const Interest& interest);
+
+  void
+  transmit(size_t idx, uint64_t faceId, const Data& data);
+
+  const std::map<uint64_t, uint64_t>*
+  lookupFib(const Router& router, const Name& name) const;
+
+  void
+  countPacket(const Name& name, bool isData, size_t size);
+
+private:
+  boost::asio::io_service m_io;
+  shared_ptr<VirtualSteadyClock> m_steadyClock;
+  shared_ptr<VirtualSystemClock> m_systemClock;
+  time::steady_clock::TimePoint m_startTime;
+  KeyChain m_keyChain;
+  Scheduler m_scheduler;
+  Options m_options;
+  std::string m_workDir;
+  std::vector<Router> m_routers;
+  size_t m_nPrefixes = 0;
+  std::mt19937 m_rengine;
+  std::uniform_real_distribution<double> m_lossDist;
+  Counters m_counters;
+};
+
+} // namespace emu
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_EMU_EMULATOR_HPP
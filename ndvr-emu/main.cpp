@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "emulator.hpp"
+
+#include <fstream>
+#include <unistd.h>
+
+static void
+printUsage(const std::string& programName)
+{
+  std::cout << "Usage: " << programName << " [OPTIONS...]" << std::endl;
+  std::cout << "   Run many NDVR routers in one process over emulated links (virtual time)" << std::endl;
+  std::cout << "       -t <FILE>   Mini-NDN topology file (e.g., minindn/topologies/rnp.conf)" << std::endl;
+  std::cout << "       -g <RxC>    Use a RxC grid topology instead of a topology file (e.g., 32x32)" << std::endl;
+  std::cout << "       -n <NAME>   Specify the network name (default: /ndn)" << std::endl;
+  std::cout << "       -i <SEC>    Hello interval" << std::endl;
+  std::cout << "       -v <FILE>   Validation config file (default: no signature validation)" << std::endl;
+  std::cout << "       -d <MS>     Delay of links without delay= (default: 10)" << std::endl;
+  std::cout << "       -l <PCT>    Loss of links without loss= (default: 0)" << std::endl;
+  std::cout << "       -T <MS>     Virtual clock tick (default: 1)" << std::endl;
+  std::cout << "       -D <SEC>    Virtual time to run (default: 120)" << std::endl;
+  std::cout << "       -c          Stop as soon as all routers converged" << std::endl;
+  std::cout << "       -s <SEED>   Seed for link loss (default: 1)" << std::endl;
+  std::cout << "       -o <FILE>   Write routers' log to FILE (default: discard)" << std::endl;
+  std::cout << "       -h          Display usage " << std::endl;
+}
+
+int main(int32_t argc, char** argv)
+{
+  std::string programName(argv[0]);
+
+  std::string topologyFile;
+  std::string grid;
+  std::string logFile;
+  ndn::ndvr::emu::Emulator::Options options;
+  int delayMs = 10;
+  double lossPct = 0;
+  int durationSec = 120;
+  bool stopOnConvergence = false;
+
+  int32_t opt;
+  while ((opt = getopt(argc, argv, "t:g:n:i:v:d:l:T:D:cs:o:h")) != -1) {
+    switch (opt) {
+      case 't':
+        topologyFile = optarg;
+        break;
+      case 'g':
+        grid = optarg;
+        break;
+      case 'n':
+        options.network = ndn::Name(optarg);
+        break;
+      case 'i':
+        options.helloInterval = strtol(optarg, NULL, 10);
+        break;
+      case 'v':
+        options.validationConfig = optarg;
+        break;
+      case 'd':
+        delayMs = strtol(optarg, NULL, 10);
+        break;
+      case 'l':
+        lossPct = strtod(optarg, NULL);
+        break;
+      case 'T':
+        options.tick = ndn::time::milliseconds(strtol(optarg, NULL, 10));
+        break;
+      case 'D':
+        durationSec = strtol(optarg, NULL, 10);
+        break;
+      case 'c':
+        stopOnConvergence = true;
+        break;
+      case 's':
+        options.seed = strtoul(optarg, NULL, 10);
+        break;
+      case 'o':
+        logFile = optarg;
+        break;
+      case 'h':
+      default:
+        printUsage(programName);
+        return EXIT_FAILURE;
+    }
+  }
+  if (topologyFile.empty() == grid.empty()) {
+    std::cerr << "Specify exactly one of: -t or -g" << std::endl;
+    printUsage(programName);
+    return EXIT_FAILURE;
+  }
+  if (options.tick <= ndn::time::nanoseconds::zero()) {
+    std::cerr << "Invalid tick: -T" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /* routers log through std::cout/std::cerr; keep our own report apart */
+  std::ostream report(std::cout.rdbuf());
+  std::ofstream routersLog;
+  if (!logFile.empty())
+    routersLog.open(logFile);
+  std::cout.rdbuf(routersLog.rdbuf());
+  std::cerr.rdbuf(routersLog.rdbuf());
+  if (logFile.empty()) {
+    std::cout.setstate(std::ios::badbit);
+    std::cerr.setstate(std::ios::badbit);
+  }
+
+  try {
+    ndn::ndvr::emu::Topology topology;
+    if (!grid.empty()) {
+      size_t rows = 0, cols = 0;
+      if (sscanf(grid.c_str(), "%zux%zu", &rows, &cols) != 2 || rows == 0 || cols == 0)
+        throw std::invalid_argument("Invalid grid: " + grid);
+      topology = ndn::ndvr::emu::Topology::makeGrid(rows, cols, ndn::time::milliseconds(delayMs),
+                                                     lossPct / 100.0);
+    }
+    else {
+      topology = ndn::ndvr::emu::Topology::loadMiniNdnConf(topologyFile, ndn::time::milliseconds(delayMs),
+                                                            lossPct / 100.0);
+    }
+
+    ndn::ndvr::emu::Emulator emulator(topology, options);
+    report << "routers=" << emulator.getNRouters() << " links=" << topology.links.size() << std::endl;
+    emulator.start();
+
+    /* check convergence every 100ms of virtual time */
+    const auto step = ndn::time::milliseconds(100);
+    ndn::time::nanoseconds convergenceTime(-1);
+    while (emulator.getElapsed() < ndn::time::seconds(durationSec)) {
+      emulator.advance(step);
+      if (convergenceTime < ndn::time::nanoseconds::zero() && emulator.isConverged()) {
+        convergenceTime = emulator.getElapsed();
+        if (stopOnConvergence)
+          break;
+      }
+    }
+
+    const auto& c = emulator.getCounters();
+    report << "elapsed_ms=" << ndn::time::duration_cast<ndn::time::milliseconds>(emulator.getElapsed()).count()
+           << " converged=" << (convergenceTime >= ndn::time::nanoseconds::zero())
+           << " convergence_time_ms="
+           << ndn::time::duration_cast<ndn::time::milliseconds>(convergenceTime).count() << std::endl;
+    report << "hello_interests=" << c.nHelloInterests
+           << " dvinfo_interests=" << c.nDvInfoInterests
+           << " dvinfo_data=" << c.nDvInfoData
+           << " dvinfo_bytes=" << c.nDvInfoBytes
+           << " key_interests=" << c.nKeyInterests
+           << " key_data=" << c.nKeyData
+           << " nfd_commands=" << c.nNfdCommands
+           << " lost=" << c.nLost << std::endl;
+  }
+  catch (const std::exception& e) {
+    report << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "topology.hpp"
+
+#include <boost/algorithm/string.hpp>
+
+#include <fstream>
+#include <stdexcept>
+
+namespace ndn {
+namespace ndvr {
+namespace emu {
+
+static time::nanoseconds
+parseDelay(const std::string& value)
+{
+  size_t pos = 0;
+  double amount = std::stod(value, &pos);
+  std::string unit = value.substr(pos);
+  if (unit.empty() || unit == "ms")
+    return time::nanoseconds(static_cast<int64_t>(amount * 1000000));
+  if (unit == "us")
+    return time::nanoseconds(static_cast<int64_t>(amount * 1000));
+  if (unit == "s")
+    return time::nanoseconds(static_cast<int64_t>(amount * 1000000000));
+  throw std::invalid_argument("Invalid delay unit: " + value);
+}
+
+size_t
+Topology::addNode(const std::string& name)
+{
+  nodes.push_back(TopologyNode{name, {}});
+  return nodes.size() - 1;
+}
+
+size_t
+Topology::findNode(const std::string& name) const
+{
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i].name == name)
+      return i;
+  }
+  throw std::invalid_argument("Unknown node in link: " + name);
+}
+
+Topology
+Topology::loadMiniNdnConf(const std::string& filename, time::nanoseconds defaultDelay, double defaultLoss)
+{
+  std::ifstream is(filename);
+  if (!is)
+    throw std::runtime_error("Cannot open topology file " + filename);
+
+  Topology topo;
+  std::string section;
+  std::string line;
+  while (std::getline(is, line)) {
+    boost::algorithm::trim(line);
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (line[0] == '[') {
+      section = line;
+      continue;
+    }
+
+    std::vector<std::string> tokens;
+    boost::split(tokens, line, boost::is_any_of(" \t"), boost::token_compress_on);
+
+    if (section == "[nodes]") {
+      std::string name = tokens[0];
+      if (name.back() == ':')
+        name.pop_back();
+      size_t idx = topo.addNode(name);
+      for (size_t i = 1; i < tokens.size(); ++i) {
+        if (boost::starts_with(tokens[i], "ndvr-prefixes=")) {
+          std::string value = tokens[i].substr(std::string("ndvr-prefixes=").size());
+          boost::split(topo.nodes[idx].prefixes, value, boost::is_any_of(","));
+        }
+      }
+    }
+    else if (section == "[links]") {
+      std::vector<std::string> ends;
+      boost::split(ends, tokens[0], boost::is_any_of(":"));
+      if (ends.size() != 2)
+        throw std::invalid_argument("Invalid link: " + line);
+
+      TopologyLink link{topo.findNode(ends[0]), topo.findNode(ends[1]), defaultDelay, defaultLoss};
+      for (size_t i = 1; i < tokens.size(); ++i) {
+        if (boost::starts_with(tokens[i], "delay="))
+          link.delay = parseDelay(tokens[i].substr(6));
+        else if (boost::starts_with(tokens[i], "loss="))
+          link.loss = std::stod(tokens[i].substr(5)) / 100.0;
+      }
+      topo.links.push_back(link);
+    }
+  }
+  return topo;
+}
+
+Topology
+Topology::makeGrid(size_t rows, size_t cols, time::nanoseconds delay, double loss)
+{
+  Topology topo;
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t c = 0; c < cols; ++c) {
+      topo.addNode("r" + std::to_string(r) + "c" + std::to_string(c));
+    }
+  }
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t c = 0; c < cols; ++c) {
+      size_t idx = r * cols + c;
+      if (c + 1 < cols)
+        topo.links.push_back(TopologyLink{idx, idx + 1, delay, loss});
+      if (r + 1 < rows)
+        topo.links.push_back(TopologyLink{idx, idx + cols, delay, loss});
+    }
+  }
+  return topo;
+}
+
+} // namespace emu
+} // namespace ndvr
+} // namespace ndn
@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_EMU_TOPOLOGY_HPP
+#define NDVR_EMU_TOPOLOGY_HPP
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ndn {
+namespace ndvr {
+namespace emu {
+
+struct TopologyNode
+{
+  std::string name;
+  /* from the ndvr-prefixes=a,b,c node parameter; empty means the
+   * default /<network>/<name>-site (same as minindn/apps/ndvr.py) */
+  std::vector<std::string> prefixes;
+};
+
+struct TopologyLink
+{
+  size_t a;
+  size_t b;
+  time::nanoseconds delay;
+  double loss; // probability in [0, 1]
+};
+
+/** @brief Router graph used by the emulator
+ *
+ * Reads the Mini-NDN topology format used in minindn/topologies:
+ *
+ *    [nodes]
+ *    a: _ radius=1 angle=2.0 ndvr-prefixes=/ndn/a,/ufba
+ *    [links]
+ *    a:b delay=10ms loss=1
+ *
+ * loss follows the Mini-NDN (tc netem) convention, i.e. percent.
+ */
+class Topology
+{
+public:
+  static Topology
+  loadMiniNdnConf(const std::string& filename, time::nanoseconds defaultDelay, double defaultLoss);
+
+  /** @brief rows x cols grid, useful for scale runs (e.g. 32x32) */
+  static Topology
+  makeGrid(size_t rows, size_t cols, time::nanoseconds delay, double loss);
+
+  size_t
+  addNode(const std::string& name);
+
+  size_t
+  findNode(const std::string& name) const;
+
+public:
+  std::vector<TopologyNode> nodes;
+  std::vector<TopologyLink> links;
+};
+
+} // namespace emu
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_EMU_TOPOLOGY_HPP
@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDVR_EMU_VIRTUAL_CLOCK_HPP
+#define NDVR_EMU_VIRTUAL_CLOCK_HPP
+
+#include <ndn-cxx/util/time-custom-clock.hpp>
+
+namespace ndn {
+namespace ndvr {
+namespace emu {
+
+/** @brief Clock that only moves when the emulator advances it
+ *
+ * Installed through time::setCustomClocks, so every Scheduler, Face
+ * and Ndvr instance in the process observes the same virtual time.
+ * Timers never sleep on the wall clock: the wait duration handed to
+ * asio is always one tick of the base clock.
+ */
+template <typename BaseClock>
+class VirtualClock : public time::CustomClock<BaseClock>
+{
+public:
+  explicit
+  VirtualClock(typename BaseClock::time_point start = typename BaseClock::time_point())
+    : m_now(start)
+  {
+  }
+
+  typename BaseClock::time_point
+  getNow() const override
+  {
+    return m_now;
+  }
+
+  std::string
+  getSince() const override
+  {
+    return " since emulation start";
+  }
+
+  typename BaseClock::duration
+  toWaitDuration(typename BaseClock::duration) const override
+  {
+    return typename BaseClock::duration(1);
+  }
+
+  void
+  advance(time::nanoseconds d)
+  {
+    m_now += time::duration_cast<typename BaseClock::duration>(d);
+  }
+
+private:
+  typename BaseClock::time_point m_now;
+};
+
+using VirtualSteadyClock = VirtualClock<time::steady_clock>;
+using VirtualSystemClock = VirtualClock<time::system_clock>;
+
+} // namespace emu
+} // namespace ndvr
+} // namespace ndn
+
+#endif // NDVR_EMU_VIRTUAL_CLOCK_HPP
@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+/* ndvrc: command line client of the ndvrd management API (/localhost/ndvr) */
+
+#include "ndvr-api-commands.hpp"
+#include "ndvr-api-processor.hpp"
+#include "ndvr-status.hpp"
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/mgmt/nfd/controller.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/transport/unix-transport.hpp>
+#include <ndn-cxx/util/notification-subscriber.hpp>
+#include <ndn-cxx/util/segment-fetcher.hpp>
+
+#include <iostream>
+#include <unistd.h>
+
+namespace ndn {
+namespace ndvr {
+
+class NdvrClient
+{
+public:
+  NdvrClient(Face& face, KeyChain& keyChain)
+    : m_face(face)
+    , m_controller(face, keyChain, m_validator)
+  {
+    m_options.setPrefix("/localhost");
+  }
+
+  int
+  run(const std::string& verb, const std::vector<std::string>& args)
+  {
+    if ((verb == "advertise" || verb == "withdraw") && args.size() == 1) {
+      ndn::nfd::ControlParameters parameters;
+      parameters.setName(args[0]);
+      if (verb == "advertise")
+        m_controller.start<AdvertisePrefixCommand>(parameters,
+          std::bind(&NdvrClient::onCommandSuccess, this, verb, _1),
+          std::bind(&NdvrClient::onCommandFailure, this, verb, _1),
+          m_options);
+      else
+        m_controller.start<WithdrawPrefixCommand>(parameters,
+          std::bind(&NdvrClient::onCommandSuccess, this, verb, _1),
+          std::bind(&NdvrClient::onCommandFailure, this, verb, _1),
+          m_options);
+    }
+    else if (verb == "routes" && args.empty()) {
+      fetchRoutes(Name(NdvrApiProcessor::COMMAND_PREFIX).append("routes"));
+    }
+    else if (verb == "neighbors" && args.empty()) {
+      fetchDataset(Name(NdvrApiProcessor::COMMAND_PREFIX).append("neighbors"),
+                   [] (const Block& element) {
+                     if (element.type() == tlv::ndvr::NeighborStatus)
+                       std::cout << NeighborStatus(element) << std::endl;
+                   },
+                   [] {});
+    }
+    else if (verb == "damping" && args.empty()) {
+      fetchDataset(Name(NdvrApiProcessor::COMMAND_PREFIX).append("damping"),
+                   [] (const Block& element) {
+                     if (element.type() == tlv::ndvr::DampingStatus)
+                       std::cout << DampingStatus(element) << std::endl;
+                   },
+                   [] {});
+    }
+    else if (verb == "watch" && args.empty()) {
+      watchRoutes();
+    }
+    else {
+      std::cerr << "Unknown command or wrong arguments: " << verb << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    m_face.processEvents();
+    return m_exitCode;
+  }
+
+private:
+  void
+  onCommandSuccess(const std::string& verb, const ndn::nfd::ControlParameters& parameters)
+  {
+    std::cout << verb << " " << parameters.getName() << ": OK" << std::endl;
+  }
+
+  void
+  onCommandFailure(const std::string& verb, const ndn::nfd::ControlResponse& response)
+  {
+    std::cerr << verb << " failed: " << response.getCode() << " " << response.getText() << std::endl;
+    m_exitCode = EXIT_FAILURE;
+  }
+
+  /* one page of the routes dataset, then the next one while the router
+   * reports more (NextPage) */
+  void
+  fetchRoutes(const Name& pageName)
+  {
+    auto nextPage = std::make_shared<std::string>();
+    fetchDataset(pageName,
+                 [nextPage] (const Block& element) {
+                   if (element.type() == tlv::ndvr::RouteStatus)
+                     std::cout << RouteStatus(element) << std::endl;
+                   else if (element.type() == tlv::ndvr::NextPage)
+                     *nextPage = readString(element);
+                 },
+                 [this, nextPage] {
+                   if (nextPage->empty())
+                     return;
+                   fetchRoutes(Name(NdvrApiProcessor::COMMAND_PREFIX).append("routes")
+                               .append(name::Component(reinterpret_cast<const uint8_t*>(nextPage->data()),
+                                                       nextPage->size())));
+                 });
+  }
+
+  /* follow route-events until interrupted; a gap in the batch numbers
+   * means lost changes, which only a new routes dump can recover */
+  void
+  watchRoutes()
+  {
+    m_subscriber = make_unique<ndn::util::NotificationSubscriber<RouteChangeBatch>>(
+      m_face, Name(NdvrApiProcessor::COMMAND_PREFIX).append("route-events"), time::seconds(60));
+    m_subscriber->onNotification.connect([this] (const RouteChangeBatch& batch) {
+      if (m_lastBatch != 0 && batch.getSeqNum() != m_lastBatch + 1)
+        std::cout << "# missed " << batch.getSeqNum() - m_lastBatch - 1
+                  << " batches, run 'routes' to resynchronize" << std::endl;
+      m_lastBatch = batch.getSeqNum();
+      std::cout << batch << std::endl;
+    });
+    m_subscriber->onDecodeError.connect([] (const Data& data) {
+      std::cerr << "Malformed notification " << data.getName() << std::endl;
+    });
+    m_subscriber->start();
+  }
+
+  void
+  fetchDataset(const Name& datasetName,
+               const std::function<void(const Block&)>& onElement,
+               const std::function<void()>& onDone)
+  {
+    Interest interest(datasetName);
+    interest.setCanBePrefix(true);
+    interest.setMustBeFresh(true);
+
+    ndn::util::SegmentFetcher::Options options;
+    m_fetcher = ndn::util::SegmentFetcher::start(m_face, interest, m_validator, options);
+    m_fetcher->onComplete.connect([this, onElement, onDone] (ConstBufferPtr content) {
+      size_t offset = 0;
+      while (offset < content->size()) {
+        bool isOk = false;
+        Block element;
+        std::tie(isOk, element) = Block::fromBuffer(content, offset);
+        if (!isOk) {
+          std::cerr << "Malformed dataset" << std::endl;
+          m_exitCode = EXIT_FAILURE;
+          return;
+        }
+        offset += element.size();
+        try {
+          onElement(element);
+        }
+        catch (const tlv::Error& e) {
+          std::cerr << "Malformed dataset entry: " << e.what() << std::endl;
+          m_exitCode = EXIT_FAILURE;
+          return;
+        }
+      }
+      onDone();
+    });
+    m_fetcher->onError.connect([this] (uint32_t code, const std::string& msg) {
+      std::cerr << "Cannot fetch dataset: " << msg << " (" << code << ")" << std::endl;
+      m_exitCode = EXIT_FAILURE;
+    });
+  }
+
+private:
+  Face& m_face;
+  /* responses come from the local router, over /localhost */
+  security::v2::ValidatorNull m_validator;
+  ndn::nfd::Controller m_controller;
+  ndn::nfd::CommandOptions m_options;
+  std::shared_ptr<ndn::util::SegmentFetcher> m_fetcher;
+  std::unique_ptr<ndn::util::NotificationSubscriber<RouteChangeBatch>> m_subscriber;
+  uint64_t m_lastBatch = 0;
+  int m_exitCode = EXIT_SUCCESS;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+static void
+printUsage(const std::string& programName)
+{
+  std::cout << "Usage: " << programName << " [-s <SOCKET>] COMMAND" << std::endl;
+  std::cout << "   Query and control a running ndvrd" << std::endl;
+  std::cout << "       -s <SOCKET>         NFD unix socket of the router (default: ndn-cxx client.conf)" << std::endl;
+  std::cout << "       -h                  Display usage" << std::endl;
+  std::cout << "" << std::endl;
+  std::cout << "COMMANDS" << std::endl;
+  std::cout << "       advertise <NAME>    Start announcing a name prefix" << std::endl;
+  std::cout << "       withdraw <NAME>     Stop announcing a name prefix" << std::endl;
+  std::cout << "       routes              List the routing table" << std::endl;
+  std::cout << "       neighbors           List the neighbors" << std::endl;
+  std::cout << "       damping             List the flapping prefixes and neighbors" << std::endl;
+  std::cout << "       watch               Print route changes as they happen" << std::endl;
+}
+
+int main(int32_t argc, char** argv)
+{
+  std::string programName(argv[0]);
+  std::string socketPath;
+
+  int32_t opt;
+  while ((opt = getopt(argc, argv, "s:h")) != -1) {
+    switch (opt) {
+      case 's':
+        socketPath = optarg;
+        break;
+      case 'h':
+      default:
+        printUsage(programName);
+        return EXIT_FAILURE;
+    }
+  }
+  if (optind >= argc) {
+    printUsage(programName);
+    return EXIT_FAILURE;
+  }
+  std::string verb(argv[optind]);
+  std::vector<std::string> args(argv + optind + 1, argv + argc);
+
+  try {
+    ndn::KeyChain keyChain;
+    std::unique_ptr<ndn::Face> face;
+    if (socketPath.empty())
+      face.reset(new ndn::Face(nullptr, keyChain));
+    else
+      face.reset(new ndn::Face(std::make_shared<ndn::UnixTransport>(socketPath), keyChain));
+
+    ndn::ndvr::NdvrClient client(*face, keyChain);
+    return client.run(verb, args);
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
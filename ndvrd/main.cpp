@@ -1,5 +1,6 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
+#include "ndvr-multi-runner.hpp"
 #include "ndvr-runner.hpp"
 
 int main(int32_t argc, char** argv)
@@ -13,13 +14,24 @@ int main(int32_t argc, char** argv)
   std::vector<std::string> namePrefixes;
   std::vector<std::string> faces;  // faces we will be listen (existing faceId or localUri to be created)
   std::vector<std::string> monitorFaces;  // list of face URIs we will monitor for nfd/faces/events
+  std::string signingMode = "ecdsa";
+  std::string hmacKeyFile;
+  int hmacRotation = 3600;
+  int cryptoWorkers = 0;  // inline signing/verification unless -w
+  std::string multiConfig;  // many routers in this process, see NdvrMultiRunner
+  std::string snapshotFile;  // routing state kept across restarts
+  int aggregatePrefixes = 0;  // see Ndvr::SetPrefixAggregation
+  std::string apiValidationConfig;  // who may send management commands
 
   int32_t opt;
-  while ((opt = getopt(argc, argv, "dv:c:n:r:i:p:f:m:h")) != -1) {
+  while ((opt = getopt(argc, argv, "dv:c:n:r:i:p:f:m:s:k:K:w:S:a:A:h")) != -1) {
     switch (opt) {
       case 'v':
         validationConfig = optarg;
         break;
+      case 'c':
+        multiConfig = optarg;
+        break;
       case 'n':
         networkName = optarg;
         break;
@@ -38,12 +50,46 @@ int main(int32_t argc, char** argv)
       case 'm':
         monitorFaces.push_back(optarg);
         break;
+      case 's':
+        signingMode = optarg;
+        break;
+      case 'k':
+        hmacKeyFile = optarg;
+        break;
+      case 'K':
+        hmacRotation = strtol(optarg, NULL, 10);
+        break;
+      case 'w':
+        cryptoWorkers = strtol(optarg, NULL, 10);
+        break;
+      case 'S':
+        snapshotFile = optarg;
+        break;
+      case 'a':
+        aggregatePrefixes = strtol(optarg, NULL, 10);
+        break;
+      case 'A':
+        apiValidationConfig = optarg;
+        break;
       case 'h':
       default:
         ndn::ndvr::NdvrRunner::printUsage(programName);
         return EXIT_FAILURE;
     }
   }
+  if (!multiConfig.empty()) {
+    try {
+      ndn::ndvr::NdvrMultiRunner runner(multiConfig);
+      std::cerr << "Running " << runner.getNRouters() << " routers from " << multiConfig << std::endl;
+      runner.run();
+    }
+    catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+
   if (networkName.empty()) {
     std::cerr << "Missing mandatory argument: -n " << std::endl;
     ndn::ndvr::NdvrRunner::printUsage(programName);
@@ -65,9 +111,16 @@ int main(int32_t argc, char** argv)
     return EXIT_FAILURE;
   }
 
-  ndn::ndvr::NdvrRunner runner(networkName, routerName, helloInterval, validationConfig, namePrefixes, faces, monitorFaces);
+  if (signingMode == "hmac" && hmacKeyFile.empty()) {
+    std::cerr << "HMAC signing requires the network secret: -k" << std::endl;
+    ndn::ndvr::NdvrRunner::printUsage(programName);
+    return EXIT_FAILURE;
+  }
 
   try {
+    ndn::ndvr::NdvrRunner runner(networkName, routerName, helloInterval, validationConfig, namePrefixes, faces, monitorFaces,
+                                 signingMode, hmacKeyFile, hmacRotation, cryptoWorkers, snapshotFile,
+                                 aggregatePrefixes, apiValidationConfig);
     runner.run();
   }
   catch (const std::exception& e) {
@@ -157,6 +157,8 @@ int main (int argc, char *argv[])
   uint32_t numNodes = 25;  // by default, 5x5
   bool verbose = false;
   bool tracing = false;
+  uint32_t adHocDelay = 0;  // ms, 0 disables rebroadcast suppression
+  uint32_t adHocThreshold = 1;
 
   CommandLine cmd;
   cmd.AddValue ("phyMode", "Wifi Phy mode", phyMode);
@@ -164,6 +166,8 @@ int main (int argc, char *argv[])
   cmd.AddValue ("verbose", "turn on all WifiNetDevice log components", verbose);
   cmd.AddValue ("tracing", "turn on ascii and pcap tracing", tracing);
   cmd.AddValue ("numNodes", "number of nodes", numNodes);
+  cmd.AddValue ("adHocDelay", "max random assessment delay (ms) of localhop Interests on ad hoc faces", adHocDelay);
+  cmd.AddValue ("adHocThreshold", "overheard Interests suppressing a localhop Interest", adHocThreshold);
   cmd.Parse (argc, argv);
 
   // Fix non-unicast data rate to be the same as that of unicast
@@ -231,6 +235,13 @@ int main (int argc, char *argv[])
 
   // Choosing forwarding strategy
   ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/multicast");
+  if (adHocDelay > 0)
+    {
+      ndn::StrategyChoiceHelper::InstallAll("/localhop/ndvr",
+                                            "/localhost/nfd/strategy/localhop/%FD%01/ad-hoc-delay~"
+                                            + std::to_string(adHocDelay) + "/ad-hoc-threshold~"
+                                            + std::to_string(adHocThreshold));
+    }
 
   // Security
   std::string network = "/ufba.br";
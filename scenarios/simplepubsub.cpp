@@ -66,12 +66,16 @@ main(int argc, char* argv[])
   double distance = 800;
   uint32_t syncDataRounds = 5;
   bool tracing = false;
+  bool stateVector = false;
+  uint32_t fetchWindow = 8;
 
   CommandLine cmd;
   cmd.AddValue("numNodes", "numNodes", numNodes);
   cmd.AddValue("wifiRange", "the wifi range", range);
   cmd.AddValue ("distance", "distance (m)", distance);
   cmd.AddValue ("syncDataRounds", "number of rounds to run the publish / sync Data", syncDataRounds);
+  cmd.AddValue("stateVector", "sync with state vectors instead of a notify per name", stateVector);
+  cmd.AddValue("fetchWindow", "max Interests in flight per node in state vector mode", fetchWindow);
   cmd.AddValue("run", "run number", run);
   cmd.AddValue("traceFile", "Ns2 movement trace file", traceFile);
   cmd.AddValue("tracing", "enable wifi tracing", tracing);
@@ -153,6 +157,8 @@ main(int argc, char* argv[])
 
     ndn::AppHelper appHelper("SimplePubSubApp");
     appHelper.SetAttribute("SyncDataRounds", IntegerValue(syncDataRounds));
+    appHelper.SetAttribute("StateVectorSync", BooleanValue(stateVector));
+    appHelper.SetAttribute("FetchWindow", UintegerValue(fetchWindow));
     appHelper.Install(node).Start(MilliSeconds(10*idx));
 
     // Producer